@@ -160,6 +160,328 @@ size_t test_Json2Yaml()
 }
 
 
+// stream-to-stream output must match the document serializers
+size_t test_serializeYml_stream_parity( const char* src_str )
+{
+  size_t bytes_out = 0;
+  OutputFormat_t formats[] = { OUTPUT_YAML, OUTPUT_JSON, OUTPUT_JSON_PRETTY };
+  YAMLNode yamlnode = YAMLNode::loadString( src_str );
+  for( size_t i=0; i<3; i++ ) {
+    String src = String( src_str );
+    StringStream src_stream( src );
+    String from_stream;
+    StringStream dest_stream( from_stream );
+    String from_document;
+    size_t stream_bytes = serializeYml( src_stream, dest_stream, formats[i] );
+    serializeYml( yamlnode.getDocument(), from_document, formats[i] );
+    if( stream_bytes == 0 || from_stream != from_document ) {
+      YAML_LOG_e("Output format #%d differs:\n%s\n", (int)formats[i], from_stream.c_str() );
+      return 0;
+    }
+    bytes_out += stream_bytes;
+  }
+  return bytes_out;
+}
+
+size_t test_Yaml2Json_stream()
+{
+  return test_serializeYml_stream_parity( yaml_sample_str );
+}
+
+size_t test_Json2Yaml_stream()
+{
+  return test_serializeYml_stream_parity( json_sample_str );
+}
+
+size_t test_Deep2Json_stream()
+{
+  String deep_str; // deeper than YAML_STREAM_MAX_DEPTH, alternating maps and sequences
+  for( int i=0; i<40; i++ ) deep_str += (i&1) ? "[" : "{\"k\": ";
+  deep_str += "1";
+  for( int i=39; i>=0; i-- ) deep_str += (i&1) ? "]" : "}";
+  return test_serializeYml_stream_parity( deep_str.c_str() );
+}
+
+
+// scanner edge cases: runs longer than a machine word or a vector, ending on
+// indicators, comments, tabs, line breaks or multibyte characters
+const char* scanner_samples[][2] =
+{
+  { "key: the quick brown fox jumps over the lazy dog, again and again\n",
+    "{\"key\": \"the quick brown fox jumps over the lazy dog, again and again\"}" },
+  { "url: http://example.com:8080/some/long/path/segment?query=value\n",
+    "{\"url\": \"http://example.com:8080/some/long/path/segment?query=value\"}" },
+  { "[abcdefghijklmnopqrstuvwxyz,ABCDEFGHIJKLMNOPQRSTUVWXYZ0123,{k1234567890123456: v},long plain in flow]\n",
+    "[\"abcdefghijklmnopqrstuvwxyz\", \"ABCDEFGHIJKLMNOPQRSTUVWXYZ0123\", {\"k1234567890123456\": \"v\"}, \"long plain in flow\"]" },
+  { "{ key_longer_than_sixteen: http://x.y:80/path_and_more, ten: [eleven_twelve_thirteen] }\n",
+    "{\"key_longer_than_sixteen\": \"http://x.y:80/path_and_more\", \"ten\": [\"eleven_twelve_thirteen\"]}" },
+  { "a: value#not_a_comment_abcdefghijklmnop   \t # a comment long enough to span several words\nb:          \t  2\n",
+    "{\"a\": \"value#not_a_comment_abcdefghijklmnop\", \"b\": 2}" },
+  { "# leading comment spanning more than sixteen bytes\t\twith tabs\n                        deep:\n                                    deeper: indented by thirty-six\n",
+    "{\"deep\": {\"deeper\": \"indented by thirty-six\"}}" },
+  { "folded: first line that is quite long\n  second line, also long enough\n\n  third after a blank\n",
+    "{\"folded\": \"first line that is quite long second line, also long enough\\nthird after a blank\"}" },
+  { "crlf: carriage return line feed endings here\r\nnext: 1234567890123456789\r\n",
+    "{\"crlf\": \"carriage return line feed endings here\", \"next\": 1234567890123456789}" },
+  { "text: 0123456789abcd\xc3\xa9\xe6\x97\xa5\xe6\x9c\xac and more ascii text after the multibyte \xf0\x9f\x8e\x89\n",
+    "{\"text\": \"0123456789abcd\xc3\xa9\xe6\x97\xa5\xe6\x9c\xac and more ascii text after the multibyte \xf0\x9f\x8e\x89\"}" },
+  { "- -dash_started_plain_scalar_longer_than_a_word\n- ?question_started_plain_scalar_longer\n- a::b:::c\n",
+    "[\"-dash_started_plain_scalar_longer_than_a_word\", \"?question_started_plain_scalar_longer\", \"a::b:::c\"]" },
+};
+
+
+size_t test_Yaml2Json_scanner()
+{
+  size_t bytes_out = 0;
+  for( size_t i=0; i<sizeof(scanner_samples)/sizeof(scanner_samples[0]); i++ ) {
+    YAMLNode yamlnode = YAMLNode::loadString( scanner_samples[i][0] );
+    String json_str;
+    serializeYml( yamlnode.getDocument(), json_str, OUTPUT_JSON );
+    YAML_LOG_n( "[sample #%d][=>] %s", (int)i, json_str.c_str() );
+    if( json_str != scanner_samples[i][1] ) {
+      YAML_LOG_e("Expected: %s", scanner_samples[i][1] );
+      return 0;
+    }
+    bytes_out += json_str.length();
+  }
+  return bytes_out;
+}
+
+
+// reader edge cases: multibyte characters at every offset of a word or a vector
+// and across raw buffer refills, invalid input must still be rejected
+String reader_sample_value( int i )
+{
+  String value;
+  for( int j=0; j<i%37; j++ ) value += (char)('a' + j%26);
+  return value + "\xc3\xa9\xe6\x97\xa5\xf0\x9f\x8e\x89 tail"; // 2, 3 and 4 bytes sequences
+}
+
+
+size_t test_Yaml_reader_utf8()
+{
+  size_t out_len = 0;
+  const int lines = 120; // a few KB, several times the raw input buffer
+  String yaml_str;
+  for( int i=0; i<lines; i++ ) yaml_str += "k" + String(i) + ": " + reader_sample_value(i) + "\n";
+
+  StringStream yaml_stream( yaml_str );
+  YAMLNode from_string = YAMLNode::loadString( yaml_str.c_str() );
+  YAMLNode from_stream = YAMLNode::loadStream( yaml_stream );
+  for( int i=0; i<lines; i++ ) {
+    String key = "k" + String(i);
+    String expected = reader_sample_value(i);
+    const char* text = from_string.gettext( key.c_str() );
+    const char* streamed = from_stream.gettext( key.c_str() );
+    if( !text || !streamed || expected != text || expected != streamed ) {
+      YAML_LOG_e("[%s] expected '%s', got '%s' / '%s'", key.c_str(), expected.c_str(), text, streamed );
+      return 0;
+    }
+    out_len += strlen(text);
+  }
+  YAML_LOG_n( "[k%d][=>] %s", lines-1, from_stream.gettext( ("k" + String(lines-1)).c_str() ) );
+
+  const char* invalid[] = {
+    "k: abcdefghijklmnop\x01qrstuvwxyz\n",         // control character
+    "k: abcdefghijklmnopqrstuvwxyz\x7f\n",         // DEL
+    "k: abcdefghijklmnop\xc3\x28qrstuvwxyz\n",     // bad continuation byte
+    "k: abcdefghijklmnop\xbfqrstuvwxyz\n",         // stray continuation byte
+    "k: abcdefghijklmnopqrstuvwxyz\xe6\x97",       // truncated sequence
+  };
+  for( size_t i=0; i<sizeof(invalid)/sizeof(invalid[0]); i++ ) {
+    YAMLEventHandler handler; // SAX parsing reports errors without throwing
+    if( deserializeYml( handler, invalid[i] ) != -1 ) {
+      YAML_LOG_e("Invalid sample #%d was accepted", (int)i );
+      return 0;
+    }
+  }
+  return out_len;
+}
+
+
+// logs SAX events in a compact form, stops parsing after the 'stop_key' key
+struct EventLogger : public YAMLEventHandler
+{
+  String events;
+  const char* stop_key = nullptr;
+  bool onDocumentStart() override { events += "+DOC "; return true; }
+  bool onDocumentEnd() override { events += "-DOC"; return true; }
+  bool onMappingStart( const char* /*tag*/, const char* anchor, bool is_key ) override { log( "{", anchor, is_key ); return true; }
+  bool onMappingEnd() override { events += "} "; return true; }
+  bool onSequenceStart( const char* /*tag*/, const char* anchor, bool is_key ) override { log( "[", anchor, is_key ); return true; }
+  bool onSequenceEnd() override { events += "] "; return true; }
+  bool onScalar( const char* value, size_t /*length*/, yaml_scalar_style_t /*style*/, const char* /*tag*/, const char* anchor, bool is_key ) override
+  {
+    log( value, anchor, is_key );
+    return !( is_key && stop_key && strcmp( value, stop_key ) == 0 );
+  }
+  bool onAlias( const char* anchor, bool is_key ) override { events += "*"; log( anchor, nullptr, is_key ); return true; }
+  void log( const char* value, const char* anchor, bool is_key )
+  {
+    if( anchor ) events += String("&") + anchor + " ";
+    events += String( is_key ? "k:" : "" ) + value + " ";
+  }
+};
+
+
+size_t test_deserializeYml_events()
+{
+  const char* src_str = "a: 1\nb: [x, {c: 2}]\nd: &anchor 3\ne: *anchor\nf: 4\n";
+  const char* expected_all  = "+DOC { k:a 1 k:b [ x { k:c 2 } ] k:d &anchor 3 k:e *anchor k:f 4 } -DOC";
+  const char* expected_stop = "+DOC { k:a 1 k:b [ x { k:c ";
+
+  EventLogger all;
+  int bytes_in = deserializeYml( all, src_str );
+  YAML_LOG_n( "[all events][=>] %s", all.events.c_str() );
+  if( bytes_in != (int)strlen(src_str) || all.events != expected_all ) return 0;
+
+  EventLogger early; // stopping is not an error, and no event follows
+  early.stop_key = "c";
+  String src = String( src_str );
+  StringStream src_stream( src );
+  bytes_in = deserializeYml( early, src_stream );
+  YAML_LOG_n( "[stopped at 'c'][=>] %s", early.events.c_str() );
+  if( bytes_in < 0 || early.events != expected_stop ) return 0;
+  return all.events.length() + early.events.length();
+}
+
+
+// in-situ load must give the same document as the copying load
+size_t test_Yaml_loadStringInSitu()
+{
+  size_t bytes_out = 0;
+  char* buffer = (char*)malloc( yaml_str_size+1 ); // caller owned, must outlive the document
+  if( !buffer ) return 0;
+  memcpy( buffer, yaml_sample_str, yaml_str_size+1 );
+  {
+    YAMLNode copied = YAMLNode::loadString( yaml_sample_str );
+    YAMLNode insitu = YAMLNode::loadStringInSitu( buffer );
+    String copied_json, insitu_json;
+    serializeYml( copied.getDocument(), copied_json, OUTPUT_JSON );
+    serializeYml( insitu.getDocument(), insitu_json, OUTPUT_JSON );
+    const char* plain = insitu.gettext( "blah:array_of_anonymous_objects:0:prop1" ); // plain scalar, not copied
+    bool is_view = plain >= buffer && plain < buffer + yaml_str_size;
+    bool is_modified = memcmp( buffer, yaml_sample_str, yaml_str_size ) != 0; // scalars are terminated in place
+    if( insitu_json != copied_json || !is_view || !is_modified ) {
+      YAML_LOG_e("In-situ document differs (view=%d, modified=%d):\n%s\n", is_view, is_modified, insitu_json.c_str() );
+    } else {
+      Serial.println( insitu_json );
+      bytes_out = insitu_json.length();
+    }
+  }
+  free( buffer );
+  return bytes_out;
+}
+
+
+// binary stream over a 4 bytes aligned buffer, holds snapshot images
+class SnapshotStream : public Stream
+{
+public:
+  std::vector<uint32_t> words;
+  size_t size = 0;
+  size_t pos = 0;
+  uint8_t* image() { return (uint8_t*)words.data(); }
+  virtual int available() { return size - pos; }
+  virtual int read() { return pos < size ? image()[pos++] : -1; }
+  virtual int peek() { return pos < size ? image()[pos] : -1; }
+  virtual size_t write( uint8_t c ) { if( size%4 == 0 ) words.push_back(0); image()[size++] = c; return 1; }
+  virtual void flush() {}
+  using Print::write;
+};
+
+
+// invalid images give a null node, or throw when exceptions are enabled
+template <typename Loader>
+bool snapshot_rejected( Loader load )
+{
+  #if defined __cpp_exceptions
+    try {
+      return load().isNull();
+    } catch( const std::runtime_error &e ) {
+      YAML_LOG_n( "[rejected] %s", e.what() );
+      return true;
+    }
+  #else
+    return load().isNull();
+  #endif
+}
+
+
+size_t test_Yaml_snapshot()
+{
+  YAMLNode yamlnode = YAMLNode::loadString( yaml_sample_str );
+  SnapshotStream snapshot;
+  size_t image_size = YAMLNode::saveSnapshot( yamlnode.getDocument(), snapshot );
+  if( image_size == 0 || image_size != snapshot.size ) return 0;
+
+  String expected, from_image, from_stream;
+  serializeYml( yamlnode.getDocument(), expected, OUTPUT_JSON );
+  {
+    YAMLNode loaded = YAMLNode::loadSnapshot( snapshot.image(), image_size ); // zero-copy
+    serializeYml( loaded.getDocument(), from_image, OUTPUT_JSON );
+  }
+  {
+    YAMLNode loaded = YAMLNode::loadSnapshot( snapshot ); // one read
+    serializeYml( loaded.getDocument(), from_stream, OUTPUT_JSON );
+  }
+  if( from_image != expected || from_stream != expected ) {
+    YAML_LOG_e("Snapshot differs from source document:\n%s\n", from_image.c_str() );
+    return 0;
+  }
+  Serial.println( from_image );
+
+  // truncated images
+  size_t truncated_sizes[] = { image_size-4, (image_size/2) & ~(size_t)3, 8 };
+  for( size_t i=0; i<3; i++ ) {
+    if( !snapshot_rejected( [&]() { return YAMLNode::loadSnapshot( snapshot.image(), truncated_sizes[i] ); } ) ) return 0;
+    SnapshotStream truncated = snapshot;
+    truncated.size = truncated_sizes[i];
+    truncated.pos = 0;
+    if( !snapshot_rejected( [&]() { return YAMLNode::loadSnapshot( truncated ); } ) ) return 0;
+  }
+  // corrupted images: bad magic, unterminated string pool
+  size_t corrupted_offsets[] = { 0, image_size-1 };
+  for( size_t i=0; i<2; i++ ) {
+    SnapshotStream corrupted = snapshot;
+    corrupted.image()[corrupted_offsets[i]] ^= 0x5a;
+    if( !snapshot_rejected( [&]() { return YAMLNode::loadSnapshot( corrupted.image(), image_size ); } ) ) return 0;
+  }
+  return from_image.length();
+}
+
+
+// read-only view over a snapshot image must answer like the loaded document
+size_t test_YAMLNodeView_gettext()
+{
+  size_t out_len = 0;
+  YAMLNode root = YAMLNode::loadString( yaml_sample_str );
+  SnapshotStream snapshot;
+  size_t image_size = YAMLNode::saveSnapshot( root.getDocument(), snapshot );
+  YAMLNodeView view( snapshot.image(), image_size );
+  if( image_size == 0 || view.isNull() ) return 0;
+
+  size_t paths_count = sizeof( testpaths ) / sizeof( const char*);
+  for( size_t i=0;i<paths_count; i++ ) {
+    const char* text = view.gettext( testpaths[i] );
+    const char* expected = root.gettext( testpaths[i] );
+    YAML_LOG_n( "[%s][=>] %s", testpaths[i], text );
+    bool is_same = ( text == testpaths[i] && expected == testpaths[i] ) // not found
+                || ( text && expected && strcmp( text, expected ) == 0 );
+    if( !is_same ) return 0;
+    out_len += text ? strlen(text) : 0;
+  }
+  static const yaml_path_t prop4Path( "blah:array_of_anonymous_objects:1:prop4" );
+  const char* prop4 = view.gettext( prop4Path );
+  if( !prop4 || strcmp( prop4, "wat" ) != 0 ) return 0;
+  if( view["blah"]["array_mixed"].size() != 4 || !view["whatever"]["nope"][3].isScalar() ) return 0;
+
+  snapshot.image()[0] ^= 0x5a; // bad magic
+  if( !YAMLNodeView( snapshot.image(), image_size ).isNull() ) return 0;
+  return out_len;
+}
+
+
 size_t test_Yaml_gettext_trait()
 {
   const char* blah = YAMLNode::loadString(yaml_sample_str).gettext("blah:just_a_string"); // value should be "true"
@@ -227,6 +549,75 @@ size_t test_Json_gettext_stream()
 }
 
 
+size_t test_Yaml_gettext_filtered()
+{
+  size_t out_len = 0;
+  const char* paths[] = { "blah:array_of_anonymous_objects:1", "blah:inline_json_for_the_haters", "last" };
+  YAMLNode root = YAMLNode::loadString( yaml_sample_str );
+  YAMLNode filtered = YAMLNode::loadString( yaml_sample_str, paths, 3 ); // only selected subtrees are composed
+  const char* selected[] = { "blah:array_of_anonymous_objects:1:prop4", "blah:inline_json_for_the_haters:nested:3", "last" };
+  for( size_t i=0;i<3; i++ ) {
+    const char* text = filtered.gettext( selected[i] );
+    const char* expected = root.gettext( selected[i] );
+    YAML_LOG_n( "[%s][=>] %s", selected[i], text );
+    if( !text || !expected || strcmp( text, expected ) != 0 ) return 0;
+    out_len += strlen(text);
+  }
+  const char* skipped[] = { "first", "blah:just_a_string" };
+  for( size_t i=0;i<2; i++ ) {
+    if( filtered.gettext( skipped[i] ) != skipped[i] ) return 0; // not composed, gettext() returns the path
+  }
+
+  // aliases resolve to anchored nodes outside the selection
+  const char* prod[] = { "prod" };
+  YAMLNode aliased = YAMLNode::loadString( "defaults: &d { timeout: 5 }\nprod: *d\n", prod, 1 );
+  const char* timeout = aliased.gettext( "prod:timeout" );
+  YAML_LOG_n( "[%s][=>] %s", "prod:timeout", timeout );
+  if( !timeout || strcmp( timeout, "5" ) != 0 ) return 0;
+  return out_len + strlen(timeout);
+}
+
+
+size_t test_YAMLDocumentReader_stream()
+{
+  size_t out_len = 0;
+  String yaml_str = String( yaml_sample_str ) + "---\n" + String( json_sample_str ) + "---\n" + String( yaml_sample_str );
+  StringStream yaml_stream( yaml_str );
+  YAMLDocumentReader reader( yaml_stream );
+  for( YAMLNode &doc : reader ) {
+    const char* text = doc.gettext( "blah:array_of_anonymous_objects:1:prop4" );
+    YAML_LOG_n( "[document #%d][=>] %s", (int)reader.count(), text );
+    if( !text || strcmp( text, "wat" ) != 0 ) return 0;
+    out_len += strlen(text);
+  }
+  if( reader.error() || reader.count() != 3 ) return 0;
+  return out_len;
+}
+
+
+size_t test_YAMLDocumentReader_json_lines()
+{
+  size_t out_len = 0;
+  const char* jsonl_str = "{\"id\":1,\"tags\":[\"a\"]}\n{\"id\":2,\"tags\":[]}\r\n\n[3]\n\"4\"\n";
+  const char* expected[] = { "1", "2", "3", "4" };
+  String jsonl = String( jsonl_str );
+  StringStream jsonl_stream( jsonl );
+  YAMLDocumentReader reader( jsonl_stream, YAMLDocumentReader::INPUT_JSON_LINES );
+  for( YAMLNode &record : reader ) {
+    const char* text = record.isMap() ? record.gettext( "id" ) : record.isSequence() ? record[0].scalar() : record.scalar();
+    YAML_LOG_n( "[record #%d][=>] %s", (int)reader.count(), text );
+    if( reader.count() > 4 || !text || strcmp( text, expected[reader.count()-1] ) != 0 ) return 0;
+    out_len += strlen(text);
+  }
+  if( reader.error() || reader.count() != 4 ) return 0;
+
+  YAMLDocumentReader invalid( "{\"id\":1}\n{\"id\":2} {\"id\":3}\n", YAMLDocumentReader::INPUT_JSON_LINES ); // two values on one line
+  for( YAMLNode &record : invalid ) { (void)record; }
+  if( !invalid.error() || invalid.count() != 1 ) return 0;
+  return out_len;
+}
+
+
 
 #if defined HAS_ARDUINOJSON
 
@@ -426,6 +817,43 @@ size_t test_Json_gettext_stream()
     return bytes_out;
   }
 
+
+  size_t test_deserializeYmlPool_cJson_String()
+  {
+    cJSON* objPtr;
+    cJSON* poolPtr;
+    if( deserializeYml( &objPtr, yaml_sample_str )<0 ) {
+      Serial.println("deserializeYml failed");
+      return 0;
+    }
+    if( deserializeYmlPool( &poolPtr, yaml_sample_str )<0 ) {
+      Serial.println("deserializeYmlPool failed");
+      cJSON_Delete( objPtr );
+      return 0;
+    }
+    char* json = cJSON_Print( objPtr );
+    char* pool_json = cJSON_Print( poolPtr );
+    cJSON* dupPtr = cJSON_Duplicate( poolPtr, true ); // shares keys with the pool, deleted first
+    char* dup_json = cJSON_PrintUnformatted( dupPtr );
+    char* pool_json_min = cJSON_PrintUnformatted( poolPtr );
+    size_t bytes_out = 0;
+    if( json && pool_json && dup_json && pool_json_min && strcmp( json, pool_json )==0 && strcmp( dup_json, pool_json_min )==0 ) {
+      Serial.println( pool_json );
+      bytes_out = strlen( pool_json );
+    } else {
+      YAML_LOG_e("pooled cJSON object differs from cJSON_Delete() compatible object");
+    }
+    cJSON_free( pool_json_min );
+    cJSON_free( dup_json );
+    cJSON_free( pool_json );
+    cJSON_free( json );
+    cJSON_Delete( dupPtr );
+    deleteYml_cJSONPool( poolPtr );
+    cJSON_Delete( objPtr );
+    YAML_LOG_n("[YAML=>cJsonObject pool] yaml bytes in=%d, json bytes out=%d\n", yaml_str_size, bytes_out );
+    return bytes_out;
+  }
+
 #endif
 
 
@@ -481,6 +909,18 @@ void setup()
   test_fn( test_Yaml2JsonPretty,     "serializeYml", "Yaml2JsonPretty",       "serializeYml(yaml_document_t*, Stream&, OUTPUT_JSON_PRETTY)" );
   test_fn( test_Yaml2Json,           "serializeYml", "Yaml2Json",             "serializeYml(yaml_document_t*, Stream&, OUTPUT_JSON)" );
   test_fn( test_Json2Yaml,           "serializeYml", "Json2Yaml",             "serializeYml(yaml_document_t*, Stream&, OUTPUT_YAML)" );
+  test_fn( test_Yaml2Json_stream,    "serializeYml", "Yaml2Json (stream)",    "serializeYml(Stream&, Stream&, OutputFormat_t)" );
+  test_fn( test_Json2Yaml_stream,    "serializeYml", "Json2Yaml (stream)",    "serializeYml(Stream&, Stream&, OutputFormat_t)" );
+  test_fn( test_Deep2Json_stream,    "serializeYml", "Deep2Json (stream)",    "serializeYml(Stream&, Stream&, OutputFormat_t)" );
+  test_fn( test_Yaml2Json_scanner,    "loadString",   "Scanner edge cases",    "YAMLNode::loadString(const char*)" );
+  test_fn( test_Yaml_reader_utf8,     "loadString",   "UTF-8 reader edge cases", "YAMLNode::loadString(const char*), YAMLNode::loadStream(Stream&)" );
+  test_fn( test_deserializeYml_events, "deserializeYml", "YAML string/stream to SAX events", "deserializeYml(YAMLEventHandler&, const char*)" );
+  test_fn( test_Yaml_loadStringInSitu, "loadString", "YAML in-situ load",     "YAMLNode::loadStringInSitu(char*)" );
+  test_fn( test_Yaml_snapshot,        "loadSnapshot", "YAML binary snapshot", "YAMLNode::saveSnapshot(yaml_document_t*, Stream&)" );
+  test_fn( test_YAMLNodeView_gettext, "YAMLNodeView", "Snapshot view gettext", "YAMLNodeView(const uint8_t*, size_t).gettext(const char*)" );
+  test_fn( test_Yaml_gettext_filtered, "gettext",    "YAML gettext (filtered)", "YAMLNode::loadString(const char*, const char* const*, size_t)" );
+  test_fn( test_YAMLDocumentReader_stream,     "YAMLDocumentReader", "Multi-document YAML/JSON stream", "for( YAMLNode &doc : YAMLDocumentReader(Stream&) )" );
+  test_fn( test_YAMLDocumentReader_json_lines, "YAMLDocumentReader", "JSON-lines stream", "YAMLDocumentReader(Stream&, INPUT_JSON_LINES)" );
 
 
   YAML_LOG_n("### YAMLParser libyaml tests complete\n");
@@ -510,6 +950,7 @@ void setup()
     test_fn( test_deserializeYml_cJson_Stream, "deserializeYml", "YAML stream to cJSON Object", "deserializeYml(cJSON_obj*, Stream&)");
     test_fn( test_serializeYml_cJson_Stream,   "serializeYml",   "cJSON Object to YAML stream", "serializeYml(cJSON_obj*, Stream&)");
     test_fn( test_serializeYml_cJson_String,   "serializeYml",   "cJSON Object to YAML string", "serializeYml(cJSON_obj*, String&)");
+    test_fn( test_deserializeYmlPool_cJson_String, "deserializeYml", "YAML string to pooled cJSON Object", "deserializeYmlPool(cJSON_obj*, const char*)");
 
     YAML_LOG_n("### cJSON tests complete\n");
   #endif
@@ -78,9 +78,9 @@ void test_fn( test_fn_t fn, const char *fn_name, const char* desc, const char* u
 }
 
 
-const char* fn_names[3] =
+const char* fn_names[] =
 {
-  "serializeYml", "deserializeYml", "gettext"
+  "serializeYml", "deserializeYml", "loadString", "loadSnapshot", "gettext", "YAMLNodeView", "YAMLDocumentReader"
 };
 
 
@@ -105,7 +105,7 @@ void printGlobalReport()
 {
   Serial.println(test_decorator_begin);
   Serial.println();
-  for( size_t i=0;i<3;i++ ) {
+  for( size_t i=0;i<sizeof(fn_names)/sizeof(fn_names[0]);i++ ) {
     Serial.printf("-- %s --\n", fn_names[i] );
     printReport( fn_names[i] );
   }
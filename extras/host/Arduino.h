@@ -0,0 +1,215 @@
+/*\
+ *
+ * @file
+ * @version 1.0
+ * @author tobozo <tobozo@users.noreply.github.com>
+ * @section DESCRIPTION
+ *
+ * Minimal Arduino API shim for host (Linux) builds of YAMLDuino
+ *
+ * Only provides what the library and the benchmark need: String, Print,
+ * Stream and a Serial instance writing to stdout. Not a general purpose
+ * Arduino emulation layer.
+ *
+ * YAMLDuino
+ * Project Page: https://github.com/tobozo/YAMLDuino
+ *
+ * @section LICENSE
+ *
+ * Copyright 2022 tobozo http://github.com/tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files ("YAMLDuino"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or
+ * sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+\*/
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <assert.h>
+#include <string>
+#include <chrono>
+
+
+class String
+{
+public:
+  String() {}
+  String( const char* cstr ) : str( cstr ? cstr : "" ) {}
+  String( const char* cstr, unsigned int len ) : str( cstr, len ) {}
+  String( const String& ) = default;
+  String( String&& ) = default;
+  explicit String( char c ) : str( 1, c ) {}
+  explicit String( int value ) : str( std::to_string(value) ) {}
+  explicit String( unsigned int value ) : str( std::to_string(value) ) {}
+  explicit String( long value ) : str( std::to_string(value) ) {}
+  explicit String( unsigned long value ) : str( std::to_string(value) ) {}
+  explicit String( float value, unsigned int decimals=2 ) : String( (double)value, decimals ) {}
+  explicit String( double value, unsigned int decimals=2 )
+  {
+    char buf[32];
+    snprintf( buf, sizeof(buf), "%.*f", decimals, value );
+    str = buf;
+  }
+
+  String& operator = ( const String& ) = default;
+  String& operator = ( String&& ) = default;
+  String& operator = ( const char* cstr ) { str = cstr ? cstr : ""; return *this; }
+
+  const char* c_str() const { return str.c_str(); }
+  unsigned int length() const { return str.size(); }
+  bool reserve( unsigned int size ) { str.reserve( size ); return true; }
+
+  bool concat( const String& s ) { str += s.str; return true; }
+  bool concat( const char* cstr ) { if( cstr ) str += cstr; return true; }
+  bool concat( const char* cstr, unsigned int len ) { str.append( cstr, len ); return true; }
+  bool concat( char c ) { str += c; return true; }
+
+  String& operator += ( const String& s ) { concat( s ); return *this; }
+  String& operator += ( const char* cstr ) { concat( cstr ); return *this; }
+  String& operator += ( char c ) { concat( c ); return *this; }
+
+  friend String operator + ( const String& a, const String& b ) { String r( a ); r += b; return r; }
+  friend String operator + ( const String& a, const char* b ) { String r( a ); r += b; return r; }
+  friend String operator + ( const char* a, const String& b ) { String r( a ); r += b; return r; }
+
+  bool operator == ( const String& s ) const { return str == s.str; }
+  bool operator == ( const char* cstr ) const { return str == ( cstr ? cstr : "" ); }
+  bool operator != ( const String& s ) const { return !( *this == s ); }
+  bool operator != ( const char* cstr ) const { return !( *this == cstr ); }
+
+  char operator [] ( unsigned int index ) const { return index < str.size() ? str[index] : 0; }
+  char& operator [] ( unsigned int index ) { return str[index]; }
+
+  int indexOf( char c, unsigned int from=0 ) const { auto pos = str.find( c, from ); return pos == std::string::npos ? -1 : (int)pos; }
+  int indexOf( const char* s, unsigned int from=0 ) const { auto pos = str.find( s, from ); return pos == std::string::npos ? -1 : (int)pos; }
+  String substring( unsigned int from, unsigned int to ) const { return from < str.size() ? String( str.substr( from, to-from ).c_str() ) : String(); }
+  String substring( unsigned int from ) const { return substring( from, str.size() ); }
+  long toInt() const { return atol( str.c_str() ); }
+  double toDouble() const { return atof( str.c_str() ); }
+
+private:
+  std::string str;
+};
+
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write( uint8_t c ) = 0;
+  virtual size_t write( const uint8_t *buffer, size_t size )
+  {
+    size_t n = 0;
+    while( size-- ) n += write( *buffer++ );
+    return n;
+  }
+  size_t write( const char *str ) { return str ? write( (const uint8_t*)str, strlen(str) ) : 0; }
+  size_t write( const char *buffer, size_t size ) { return write( (const uint8_t*)buffer, size ); }
+  virtual void flush() {}
+
+  size_t print( const char* str ) { return write( str ); }
+  size_t print( const String& s ) { return write( s.c_str(), s.length() ); }
+  size_t print( char c ) { return write( (uint8_t)c ); }
+  size_t print( int value ) { return printf( "%d", value ); }
+  size_t print( unsigned int value ) { return printf( "%u", value ); }
+  size_t print( long value ) { return printf( "%ld", value ); }
+  size_t print( unsigned long value ) { return printf( "%lu", value ); }
+  size_t print( double value, int decimals=2 ) { return printf( "%.*f", decimals, value ); }
+  size_t println() { return write( "\r\n" ); }
+  template <typename T> size_t println( const T& value ) { size_t n = print( value ); return n + println(); }
+
+  size_t printf( const char* format, ... ) __attribute__ ((format (printf, 2, 3)))
+  {
+    char buf[64];
+    va_list args;
+    va_start( args, format );
+    int len = vsnprintf( buf, sizeof(buf), format, args );
+    va_end( args );
+    if( len < 0 ) return 0;
+    if( (size_t)len < sizeof(buf) ) return write( (const uint8_t*)buf, len );
+    std::string tmp( len+1, '\0' );
+    va_start( args, format );
+    vsnprintf( &tmp[0], len+1, format, args );
+    va_end( args );
+    return write( (const uint8_t*)tmp.data(), len );
+  }
+};
+
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual size_t readBytes( char *buffer, size_t length )
+  {
+    size_t count = 0;
+    while( count < length ) {
+      int c = read();
+      if( c < 0 ) break;
+      buffer[count++] = (char)c;
+    }
+    return count;
+  }
+  size_t readBytes( uint8_t *buffer, size_t length ) { return readBytes( (char*)buffer, length ); }
+  void setTimeout( unsigned long ) {}
+};
+
+
+class HardwareSerial : public Stream
+{
+public:
+  void begin( unsigned long ) {}
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+  virtual size_t write( uint8_t c ) { return fputc( c, stdout ) == EOF ? 0 : 1; }
+  virtual size_t write( const uint8_t *buffer, size_t size ) { return fwrite( buffer, 1, size, stdout ); }
+  virtual void flush() { fflush( stdout ); }
+  using Print::write;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+
+inline unsigned long millis()
+{
+  using namespace std::chrono;
+  static const auto start = steady_clock::now();
+  return duration_cast<milliseconds>( steady_clock::now() - start ).count();
+}
+
+inline unsigned long micros()
+{
+  using namespace std::chrono;
+  static const auto start = steady_clock::now();
+  return duration_cast<microseconds>( steady_clock::now() - start ).count();
+}
+
+inline void delay( unsigned long ) {}
+inline void yield() {}
@@ -0,0 +1,329 @@
+/*\
+ *
+ * YAMLDuino host benchmark
+ *
+ * Measures throughput, allocation count and peak RSS of the main
+ * conversion paths on generated documents from 1KB up to 100MB.
+ * When built with YAML_ENABLE_STATS the libyaml heap peak and event
+ * count of the last iteration are also reported.
+ *
+ * Usage: ./bench [max_size] (e.g. ./bench 100M, default=10M)
+ *
+\*/
+
+#include <ArduinoYaml.h>
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+
+HardwareSerial Serial;
+
+using namespace YAML;
+
+
+/*\
+ * @brief Allocation counters
+ *
+ * glibc specific: malloc and friends are interposed and forwarded to
+ * the __libc_* implementations, so every allocation made by libyaml,
+ * cJSON, the library and libstdc++ is counted.
+\*/
+extern "C"
+{
+  void* __libc_malloc( size_t size );
+  void* __libc_calloc( size_t nmemb, size_t size );
+  void* __libc_realloc( void* ptr, size_t size );
+  void  __libc_free( void* ptr );
+
+  static size_t alloc_count = 0;
+
+  void* malloc( size_t size ) { alloc_count++; return __libc_malloc( size ); }
+  void* calloc( size_t nmemb, size_t size ) { alloc_count++; return __libc_calloc( nmemb, size ); }
+  void* realloc( void* ptr, size_t size ) { alloc_count++; return __libc_realloc( ptr, size ); }
+  void  free( void* ptr ) { __libc_free( ptr ); }
+}
+
+
+/*\
+ * @brief Peak RSS helpers
+ *
+ * Writing "5" to /proc/self/clear_refs resets the peak RSS (VmHWM)
+ * to the current RSS (Linux >= 4.0).
+\*/
+static void reset_peak_rss()
+{
+  FILE* f = fopen( "/proc/self/clear_refs", "w" );
+  if( !f ) return;
+  fputs( "5", f );
+  fclose( f );
+}
+
+static size_t read_status_kb( const char* field )
+{
+  FILE* f = fopen( "/proc/self/status", "r" );
+  if( !f ) return 0;
+  char line[128];
+  size_t value = 0;
+  size_t field_len = strlen( field );
+  while( fgets( line, sizeof(line), f ) ) {
+    if( strncmp( line, field, field_len ) == 0 ) {
+      value = strtoul( line+field_len+1, nullptr, 10 );
+      break;
+    }
+  }
+  fclose( f );
+  return value;
+}
+
+
+// write-only stream discarding its output
+class NullStream : public Stream
+{
+public:
+  size_t bytes = 0;
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+  virtual size_t write( uint8_t ) { bytes++; return 1; }
+  virtual size_t write( const uint8_t*, size_t size ) { bytes += size; return size; }
+  using Print::write;
+};
+
+
+// read-only stream over a memory buffer
+class MemoryStream : public Stream
+{
+public:
+  MemoryStream( const std::string &s ) : str(s) {}
+  virtual int available() { return str.size() - pos; }
+  virtual int read() { return pos < str.size() ? (uint8_t)str[pos++] : -1; }
+  virtual int peek() { return pos < str.size() ? (uint8_t)str[pos] : -1; }
+  virtual size_t readBytes( char *buffer, size_t length )
+  {
+    if( length > str.size() - pos ) length = str.size() - pos;
+    memcpy( buffer, str.data()+pos, length );
+    pos += length;
+    return length;
+  }
+  virtual size_t write( uint8_t ) { return 0; }
+  using Print::write;
+private:
+  const std::string &str;
+  size_t pos = 0;
+};
+
+
+// write-only stream appending to a std::string
+class StringWriter : public Stream
+{
+public:
+  StringWriter( std::string &s ) : str(s) {}
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+  virtual size_t write( uint8_t c ) { str += (char)c; return 1; }
+  virtual size_t write( const uint8_t* buffer, size_t size ) { str.append( (const char*)buffer, size ); return size; }
+  using Print::write;
+private:
+  std::string &str;
+};
+
+
+/*\
+ * @brief Document generator
+ *
+ * Appends records mixing maps, sequences, flow collections, quoted/plain
+ * scalars, numbers, booleans and multiline strings until 'size' is reached.
+\*/
+static std::string generate_yaml( size_t size )
+{
+  std::string yml;
+  yml.reserve( size + 512 );
+  char buf[512];
+  for( size_t i=0; yml.size() < size; i++ ) {
+    snprintf( buf, sizeof(buf),
+      "item_%zu:\n"
+      "  id: %zu\n"
+      "  name: \"Item #%zu\"\n"
+      "  enabled: %s\n"
+      "  ratio: %zu.%02zu\n"
+      "  hex: 0x%04zx\n"
+      "  tags: [alpha, beta, 'gamma %zu']\n"
+      "  description: |\n"
+      "    Multiline text for item %zu,\n"
+      "    with a second line.\n"
+      "  children:\n"
+      "    - key: child_a\n"
+      "      value: %zu\n"
+      "    - key: child_b\n"
+      "      value: {x: 1, y: [1, 2, 3]}\n",
+      i, i, i, (i%2) ? "true" : "false", i%100, i%97, i&0xffff, i, i, i*3
+    );
+    yml += buf;
+  }
+  return yml;
+}
+
+
+struct bench_result_t
+{
+  double seconds;   // per iteration
+  size_t allocs;    // per iteration
+  size_t peak_kb;   // peak RSS during the run
+  size_t base_kb;   // RSS before the run
+  yaml_stats_t stats; // last iteration, zeros unless YAML_ENABLE_STATS
+};
+
+
+static bench_result_t bench( std::function<void()> fn, size_t input_size )
+{
+  using clock = std::chrono::steady_clock;
+  // small inputs are repeated to get a measurable duration
+  size_t iterations = input_size < (1<<20) ? ( (1<<22) / input_size ) : 1;
+  if( iterations < 1 ) iterations = 1;
+  reset_peak_rss();
+  size_t base_kb = read_status_kb( "VmRSS:" );
+  size_t allocs_before = alloc_count;
+  auto start = clock::now();
+  for( size_t i=0; i<iterations; i++ ) {
+    stats::reset();
+    fn();
+  }
+  double seconds = std::chrono::duration<double>( clock::now() - start ).count();
+  size_t allocs = alloc_count - allocs_before;
+  return { seconds/iterations, allocs/iterations, read_status_kb( "VmHWM:" ), base_kb, stats::get() };
+}
+
+
+static void report( const char* name, size_t input_size, bench_result_t r )
+{
+  double mbps = r.seconds > 0 ? ( input_size / (1024.0*1024.0) ) / r.seconds : 0;
+  printf( "  %-22s %10.3f ms %10.2f MB/s %12zu allocs %10zu KB peak (+%zu KB)",
+    name, r.seconds*1000.0, mbps, r.allocs, r.peak_kb, r.peak_kb > r.base_kb ? r.peak_kb - r.base_kb : 0 );
+  if( stats::enabled() )
+    printf( " %10zu KB yaml peak %10zu events", r.stats.bytes_peak/1024, r.stats.events );
+  printf( "\n" );
+}
+
+
+static size_t parse_size( const char* str )
+{
+  char* end;
+  size_t size = strtoul( str, &end, 10 );
+  switch( *end ) {
+    case 'k': case 'K': size *= 1024; break;
+    case 'm': case 'M': size *= 1024*1024; break;
+    default: break;
+  }
+  return size;
+}
+
+
+int main( int argc, char** argv )
+{
+  size_t max_size = argc > 1 ? parse_size( argv[1] ) : 10*1024*1024;
+  const size_t sizes[] = { 1024, 10*1024, 100*1024, 1024*1024, 10*1024*1024, 100*1024*1024 };
+
+  for( size_t size : sizes ) {
+    if( size > max_size ) break;
+    std::string yml = generate_yaml( size );
+    printf( "\n[%zu bytes]\n", yml.size() );
+
+    report( "parse (events)", yml.size(), bench( [&]() {
+      yaml_parser_t parser;
+      yaml_event_t event;
+      yaml_parser_initialize( &parser );
+      yaml_parser_set_input_string( &parser, (const unsigned char*)yml.data(), yml.size() );
+      bool done = false;
+      while( !done ) {
+        if( !yaml_parser_parse( &parser, &event ) ) break;
+        done = ( event.type == YAML_STREAM_END_EVENT );
+        yaml_event_delete( &event );
+      }
+      yaml_parser_delete( &parser );
+    }, yml.size() ) );
+
+    report( "load", yml.size(), bench( [&]() {
+      YAMLNode yamlnode = YAMLNode::loadString( yml.c_str(), yml.size() );
+    }, yml.size() ) );
+
+    {
+      YAMLNode yamlnode = YAMLNode::loadString( yml.c_str(), yml.size() );
+      report( "toJSON", yml.size(), bench( [&]() {
+        NullStream out;
+        serializeYml( yamlnode.getDocument(), out, OUTPUT_JSON );
+      }, yml.size() ) );
+      report( "toJSON (pretty)", yml.size(), bench( [&]() {
+        NullStream out;
+        serializeYml( yamlnode.getDocument(), out, OUTPUT_JSON_PRETTY );
+      }, yml.size() ) );
+      report( "toYAML", yml.size(), bench( [&]() {
+        NullStream out;
+        serializeYml( yamlnode.getDocument(), out, OUTPUT_YAML );
+      }, yml.size() ) );
+
+      // snapshot size differs from the yaml size, throughput is given relative to the yaml source
+      std::string snapshot;
+      StringWriter writer( snapshot );
+      YAMLNode::saveSnapshot( yamlnode.getDocument(), writer );
+      report( "save snapshot", yml.size(), bench( [&]() {
+        NullStream out;
+        YAMLNode::saveSnapshot( yamlnode.getDocument(), out );
+      }, yml.size() ) );
+      report( "load snapshot (mem)", yml.size(), bench( [&]() {
+        YAMLNode loaded = YAMLNode::loadSnapshot( (const uint8_t*)snapshot.data(), snapshot.size() );
+      }, yml.size() ) );
+      report( "load snapshot (stream)", yml.size(), bench( [&]() {
+        MemoryStream in( snapshot );
+        YAMLNode loaded = YAMLNode::loadSnapshot( in );
+      }, yml.size() ) );
+    }
+
+    report( "stream YAML->JSON", yml.size(), bench( [&]() {
+      MemoryStream in( yml );
+      NullStream out;
+      serializeYml( in, out, OUTPUT_JSON );
+    }, yml.size() ) );
+
+    #if defined HAS_CJSON
+      report( "YAML->cJSON", yml.size(), bench( [&]() {
+        cJSON* root = nullptr;
+        deserializeYml( &root, yml.c_str() );
+        cJSON_Delete( root );
+      }, yml.size() ) );
+      report( "YAML->cJSON (pool)", yml.size(), bench( [&]() {
+        cJSON* root = nullptr;
+        deserializeYmlPool( &root, yml.c_str() );
+        deleteYml_cJSONPool( root );
+      }, yml.size() ) );
+      {
+        cJSON* root = nullptr;
+        deserializeYml( &root, yml.c_str() );
+        report( "cJSON->YAML", yml.size(), bench( [&]() {
+          NullStream out;
+          serializeYml( root, out );
+        }, yml.size() ) );
+        cJSON_Delete( root );
+      }
+    #endif
+
+    #if defined HAS_ARDUINOJSON
+      report( "YAML->ArduinoJson", yml.size(), bench( [&]() {
+        JsonDocument doc;
+        deserializeYml( doc, yml.c_str() );
+      }, yml.size() ) );
+      {
+        JsonDocument doc;
+        deserializeYml( doc, yml.c_str() );
+        report( "ArduinoJson->YAML", yml.size(), bench( [&]() {
+          NullStream out;
+          serializeYml( doc.as<JsonVariant>(), out );
+        }, yml.size() ) );
+      }
+    #endif
+  }
+
+  return 0;
+}
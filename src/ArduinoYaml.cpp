@@ -39,6 +39,34 @@
 
 #include "ArduinoYaml.hpp"
 
+#if defined HAS_ARDUINOJSON
+  #include <errno.h> // for strtoll() overflow
+#endif
+
+#if defined HAS_CJSON
+  #include <limits.h> // for INT_MAX/INT_MIN
+  #include <float.h>  // for DBL_EPSILON
+  #include <math.h>   // for fabs(), isnan(), isinf()
+#endif
+
+#if defined YAML_SNAPSHOT_MAP_FILE
+  #include <fcntl.h>    // for open()
+  #include <unistd.h>   // for close()
+  #include <sys/stat.h> // for fstat()
+  #include <sys/mman.h> // for mmap()
+#endif
+
+#if defined YAML_SIMD_SSE2
+  #include <emmintrin.h>
+#elif defined YAML_SIMD_NEON
+  #include <arm_neon.h>
+#endif
+
+#if defined YAML_SNAPSHOT_MAP_PARTITION
+  #include <esp_idf_version.h>
+  #include <esp_partition.h>
+#endif
+
 
 
 namespace YAML
@@ -47,22 +75,462 @@ namespace YAML
   namespace helpers
   {
 
+    /*\
+     * @brief Bump-pointer arena for libyaml allocations
+     *
+     * Small blocks are carved from chunks and only reclaimed when the
+     * arena is destroyed, except for the most recent block which can be
+     * grown or rolled back in place (libyaml stacks and strings).
+     * Blocks bigger than a quarter chunk get their own heap allocation.
+     *
+    \*/
+    struct yaml_arena_t
+    {
+      #define YAML_ARENA_ALIGN(n) (((n)+7) & ~(size_t)7)
+      #define YAML_ARENA_HEADER YAML_ARENA_ALIGN(sizeof(size_t)) // block size, bit 0 set on large blocks
+      #define YAML_ARENA_SIZE_OF(p) (*(size_t*)((uint8_t*)(p)-YAML_ARENA_HEADER))
+
+      struct chunk_t { chunk_t *next; size_t size; size_t used; };
+      struct large_t { large_t *next; large_t *prev; };
+
+      chunk_t *chunks = nullptr;
+      large_t *larges = nullptr;
+      uint8_t *last   = nullptr; // most recent small block in the current chunk
+      const uint8_t *insitu_start = nullptr; // in-situ input buffer, not owned by the arena
+      const uint8_t *insitu_end   = nullptr;
+      size_t chunk_size;
+      yaml_allocator_t allocator;
+
+      yaml_arena_t( size_t _chunk_size ) : chunk_size(_chunk_size)
+      {
+        allocator = { &arena_malloc, &arena_realloc, &arena_free, this };
+      }
+
+      ~yaml_arena_t()
+      {
+        while( chunks ) { chunk_t *next = chunks->next; yaml_stats_free( chunk_bytes( chunks->size ) ); ::free( chunks ); chunks = next; }
+        while( larges ) { large_t *next = larges->next; yaml_stats_free( large_bytes( large_data( larges ) ) ); ::free( larges ); larges = next; }
+      }
+
+      // heap usage is reported to yaml_stats_alloc()/yaml_stats_free() as the arena bypasses yaml_malloc()
+      static size_t chunk_bytes( size_t size ) { return YAML_ARENA_ALIGN(sizeof(chunk_t)) + size; }
+      static size_t large_bytes( void *ptr ) { return YAML_ARENA_ALIGN(sizeof(large_t)) + YAML_ARENA_HEADER + (YAML_ARENA_SIZE_OF(ptr) & ~(size_t)1); }
+      uint8_t* chunk_data( chunk_t *chunk ) { return (uint8_t*)chunk + YAML_ARENA_ALIGN(sizeof(chunk_t)); }
+      uint8_t* large_data( large_t *large ) { return (uint8_t*)large + YAML_ARENA_ALIGN(sizeof(large_t)) + YAML_ARENA_HEADER; }
+
+      void* alloc( size_t size )
+      {
+        size = YAML_ARENA_ALIGN( size ? size : 1 );
+        if( size > chunk_size/4 ) {
+          large_t *large = (large_t*)::malloc( YAML_ARENA_ALIGN(sizeof(large_t)) + YAML_ARENA_HEADER + size );
+          if( !large ) return nullptr;
+          large->prev = nullptr;
+          large->next = larges;
+          if( larges ) larges->prev = large;
+          larges = large;
+          uint8_t *ptr = large_data( large );
+          YAML_ARENA_SIZE_OF(ptr) = size | 1;
+          yaml_stats_alloc( large_bytes( ptr ) );
+          return ptr;
+        }
+        if( !chunks || chunks->used + YAML_ARENA_HEADER + size > chunks->size ) {
+          chunk_t *chunk = (chunk_t*)::malloc( chunk_bytes( chunk_size ) );
+          if( !chunk ) return nullptr;
+          yaml_stats_alloc( chunk_bytes( chunk_size ) );
+          chunk->next = chunks;
+          chunk->size = chunk_size;
+          chunk->used = 0;
+          chunks = chunk;
+        }
+        uint8_t *ptr = chunk_data( chunks ) + chunks->used + YAML_ARENA_HEADER;
+        YAML_ARENA_SIZE_OF(ptr) = size;
+        chunks->used += YAML_ARENA_HEADER + size;
+        last = ptr;
+        return ptr;
+      }
+
+      bool is_insitu( void *ptr ) { return (const uint8_t*)ptr >= insitu_start && (const uint8_t*)ptr <= insitu_end; }
+
+      void release( void *ptr )
+      {
+        if( !ptr || is_insitu( ptr ) ) return;
+        size_t size = YAML_ARENA_SIZE_OF(ptr);
+        if( size & 1 ) {
+          large_t *large = (large_t*)((uint8_t*)ptr - YAML_ARENA_HEADER - YAML_ARENA_ALIGN(sizeof(large_t)));
+          if( large->prev ) large->prev->next = large->next;
+          else              larges = large->next;
+          if( large->next ) large->next->prev = large->prev;
+          yaml_stats_free( large_bytes( ptr ) );
+          ::free( large );
+        } else if( ptr == last ) { // roll back the bump pointer
+          chunks->used -= YAML_ARENA_HEADER + size;
+          last = nullptr;
+        }
+      }
+
+      void* resize( void *ptr, size_t size )
+      {
+        if( !ptr ) return alloc( size );
+        size = YAML_ARENA_ALIGN( size ? size : 1 );
+        size_t old_size = YAML_ARENA_SIZE_OF(ptr);
+        if( old_size & 1 ) {
+          large_t *large = (large_t*)((uint8_t*)ptr - YAML_ARENA_HEADER - YAML_ARENA_ALIGN(sizeof(large_t)));
+          size_t old_bytes = large_bytes( ptr );
+          large_t *moved = (large_t*)::realloc( large, YAML_ARENA_ALIGN(sizeof(large_t)) + YAML_ARENA_HEADER + size );
+          if( !moved ) return nullptr;
+          if( moved->prev ) moved->prev->next = moved;
+          else              larges = moved;
+          if( moved->next ) moved->next->prev = moved;
+          ptr = large_data( moved );
+          YAML_ARENA_SIZE_OF(ptr) = size | 1;
+          yaml_stats_free( old_bytes );
+          yaml_stats_alloc( large_bytes( ptr ) );
+          return ptr;
+        }
+        if( size <= old_size ) return ptr;
+        if( ptr == last && size <= chunk_size/4 && chunks->used - old_size + size <= chunks->size ) { // grow in place
+          chunks->used += size - old_size;
+          YAML_ARENA_SIZE_OF(ptr) = size;
+          return ptr;
+        }
+        void *new_ptr = alloc( size );
+        if( !new_ptr ) return nullptr;
+        memcpy( new_ptr, ptr, old_size );
+        release( ptr );
+        return new_ptr;
+      }
+
+      static void* arena_malloc( void *data, size_t size ) { return ((yaml_arena_t*)data)->alloc( size ); }
+      static void* arena_realloc( void *data, void *ptr, size_t size ) { return ((yaml_arena_t*)data)->resize( ptr, size ); }
+      static void  arena_free( void *data, void *ptr ) { ((yaml_arena_t*)data)->release( ptr ); }
+    };
+
+
+    /*\
+     * @brief Arena scope
+     *
+     * Routes libyaml allocations to the arena for the lifetime of this object.
+     * Must outlive the parser using it.
+     *
+    \*/
+    struct ArenaScope
+    {
+      const yaml_allocator_t *previous = nullptr;
+      bool active = false;
+      ArenaScope( yaml_arena_t *arena )
+      {
+        if( !arena ) return;
+        previous = yaml_set_allocator( &arena->allocator );
+        active = true;
+      }
+      ~ArenaScope() { if( active ) yaml_set_allocator( previous ); }
+    };
+
+
+    /*\
+     * @brief Create a document arena
+     *
+     * Returns nullptr unless enabled with setDocumentArena().
+     *
+    \*/
+    yaml_arena_t* CreateArena()
+    {
+      if( YAML::DocumentArenaChunkSize == 0 ) return nullptr;
+      return new yaml_arena_t( YAML::DocumentArenaChunkSize );
+    }
+
+
+    /*\
+     * @brief Create a document arena for in-situ loading
+     *
+     * Always returns an arena as it is the only way to tell in-situ
+     * scalars apart when the document is released.
+     *
+    \*/
+    yaml_arena_t* CreateArena( const char* insitu_buffer, size_t insitu_size )
+    {
+      yaml_arena_t *arena = new yaml_arena_t( YAML::DocumentArenaChunkSize > 0 ? YAML::DocumentArenaChunkSize : YAML_ARENA_CHUNK_SIZE );
+      arena->insitu_start = (const uint8_t*)insitu_buffer;
+      arena->insitu_end   = (const uint8_t*)insitu_buffer + insitu_size;
+      return arena;
+    }
+
+
     /*\
      * @brief Create yaml_document_t with shared pointer
      *
      * Attaches yaml_document_delete to the destructor.
+     * When an arena is given, the document takes ownership of it and
+     * the destructor releases the arena in one go instead.
      *
     \*/
-    std::shared_ptr<yaml_document_t> CreateDocument()
+    std::shared_ptr<yaml_document_t> CreateDocument( yaml_arena_t* arena )
     {
-      return std::shared_ptr<yaml_document_t>(new yaml_document_t, [](yaml_document_t *doc) {
-          yaml_document_delete(doc);
+      return std::shared_ptr<yaml_document_t>(new yaml_document_t(), [arena](yaml_document_t *doc) {
+          if( arena ) delete arena;
+          else yaml_document_delete(doc);
           delete doc;
         }
       );
     }
 
 
+    /*\
+     * @brief Mapping key index
+     *
+     * Open-addressed hash table covering the big mappings of a document,
+     * keyed on (mapping node id, key bytes). Built lazily on the first lookup
+     * in a covered mapping and never modified afterwards: the table is built
+     * aside and published atomically, so concurrent lookups are safe (when two
+     * tasks race to build it, the loser's table is discarded).
+     * Released along with the last YAMLNode holding the document.
+     *
+    \*/
+    struct yaml_key_index_t
+    {
+      struct entry_t
+      {
+        uint32_t hash;          // yaml_key_hash() result, 0 means empty slot
+        int mapping;            // mapping node id
+        yaml_node_item_t key;   // key node id
+        yaml_node_item_t value; // value node id
+      };
+      struct table_t
+      {
+        size_t mask;      // table size minus one (table size is a power of two)
+        entry_t *entries; // follows the table_t header in the same allocation
+      };
+      table_t *table = nullptr; // nullptr until built, &none when there is nothing to index
+      static table_t none;
+      ~yaml_key_index_t() { if( table && table != &none ) free( table ); }
+    };
+
+
+    yaml_key_index_t::table_t yaml_key_index_t::none = { 0, nullptr };
+
+
+    // Key index publication, plain pointer accesses on targets without lock-free atomics (single task)
+    static yaml_key_index_t::table_t* yaml_key_index_load( yaml_key_index_t* index )
+    {
+      #if defined __GCC_ATOMIC_POINTER_LOCK_FREE && __GCC_ATOMIC_POINTER_LOCK_FREE > 1
+        return __atomic_load_n( &index->table, __ATOMIC_ACQUIRE );
+      #else
+        return index->table;
+      #endif
+    }
+
+
+    static bool yaml_key_index_publish( yaml_key_index_t* index, yaml_key_index_t::table_t* table )
+    {
+      #if defined __GCC_ATOMIC_POINTER_LOCK_FREE && __GCC_ATOMIC_POINTER_LOCK_FREE > 1
+        yaml_key_index_t::table_t* expected = nullptr;
+        return __atomic_compare_exchange_n( &index->table, &expected, table, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE );
+      #else
+        if( index->table ) return false;
+        index->table = table;
+        return true;
+      #endif
+    }
+
+
+    /*\
+     * @brief Create the key index of a loaded document with shared pointer
+     *
+     * Only creates the (empty) index holder, the table is built by the first
+     * lookup needing it. Returns nullptr when the index is disabled: lookups
+     * then scan the mappings linearly.
+     *
+    \*/
+    std::shared_ptr<yaml_key_index_t> CreateKeyIndex( yaml_document_t* document )
+    {
+      (void)document;
+      #if defined YAML_DISABLE_KEY_INDEX
+        return nullptr;
+      #else
+        return std::make_shared<yaml_key_index_t>();
+      #endif
+    }
+
+
+    /*\
+     * @brief Key index hash function (key part)
+     *
+     * FNV-1a over the key bytes, does not depend on the mapping
+     * so it can be precomputed (see yaml_path_t).
+     *
+    \*/
+    uint32_t yaml_key_hash( const char* str, size_t len )
+    {
+      uint32_t hash = 2166136261u;
+      for( size_t i=0;i<len;i++ ) {
+        hash ^= (uint8_t)str[i];
+        hash *= 16777619u;
+      }
+      return hash;
+    }
+
+
+    /*\
+     * @brief Key index hash function (mapping part)
+     *
+     * Mixes a key hash with the mapping id.
+     * Never returns zero as it marks empty slots.
+     *
+    \*/
+    uint32_t yaml_key_hash( int mapping_id, uint32_t key_hash )
+    {
+      uint32_t hash = key_hash ^ ( (uint32_t)mapping_id * 0x9e3779b1u );
+      hash ^= hash >> 16;
+      hash *= 0x85ebca6bu;
+      hash ^= hash >> 13;
+      return hash ? hash : 1;
+    }
+
+
+    uint32_t yaml_key_hash( int mapping_id, const char* str, size_t len )
+    {
+      return yaml_key_hash( mapping_id, yaml_key_hash( str, len ) );
+    }
+
+
+    /*\
+     * @brief Key index builder
+     *
+     * Indexes the scalar keys of the mapping nodes holding at least
+     * YAML_KEY_INDEX_MIN_PAIRS pairs, smaller ones are scanned linearly.
+     * Duplicate keys keep their first occurence to match the linear scan.
+     * Does nothing when the index is already built, called on first lookup.
+     * Returns false when there is nothing to index or not enough memory.
+     *
+    \*/
+    static bool yaml_key_index_covers( yaml_node_t* node )
+    {
+      return node->type == YAML_MAPPING_NODE
+          && node->data.mapping.pairs.top - node->data.mapping.pairs.start >= YAML_KEY_INDEX_MIN_PAIRS;
+    }
+
+
+    bool yaml_key_index_build( yaml_document_t* document, yaml_key_index_t* index )
+    {
+      const yaml_key_index_t::table_t* built = yaml_key_index_load( index );
+      if( built ) return built != &yaml_key_index_t::none;
+
+      size_t pairs_count = 0;
+      for( yaml_node_t *node = document->nodes.start; node < document->nodes.top; node++ ) {
+        if( yaml_key_index_covers( node ) )
+          pairs_count += node->data.mapping.pairs.top - node->data.mapping.pairs.start;
+      }
+      if( pairs_count == 0 ) {
+        yaml_key_index_publish( index, &yaml_key_index_t::none );
+        return false;
+      }
+
+      size_t table_size = 16;
+      while( table_size < pairs_count*2 ) table_size <<= 1; // keep load factor under 50%
+
+      auto table = (yaml_key_index_t::table_t*)calloc( 1, sizeof(yaml_key_index_t::table_t) + table_size*sizeof(yaml_key_index_t::entry_t) );
+      if( !table ) {
+        YAML_LOG_w("Not enough memory for key index (%u entries), falling back to linear scan", (unsigned)table_size );
+        yaml_key_index_publish( index, &yaml_key_index_t::none );
+        return false;
+      }
+      auto entries = table->entries = (yaml_key_index_t::entry_t*)(table+1);
+      size_t mask = table->mask = table_size-1;
+
+      for( yaml_node_t *node = document->nodes.start; node < document->nodes.top; node++ ) {
+        if( !yaml_key_index_covers( node ) ) continue;
+        int mapping_id = node - document->nodes.start + 1;
+        for( yaml_node_pair_t *pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; ++pair ) {
+          yaml_node_t *key = yaml_document_get_node(document, pair->key);
+          if( key == nullptr || key->type != YAML_SCALAR_NODE ) continue;
+          const char* key_str = (const char*)key->data.scalar.value;
+          size_t key_len = key->data.scalar.length;
+          uint32_t hash = yaml_key_hash( mapping_id, key_str, key_len );
+          size_t slot = hash & mask;
+          bool is_dup = false;
+          while( entries[slot].hash != 0 ) {
+            if( entries[slot].hash == hash && entries[slot].mapping == mapping_id ) {
+              yaml_node_t *other = yaml_document_get_node(document, entries[slot].key);
+              if( utf8_equal( key_str, key_len, (const char*)other->data.scalar.value, other->data.scalar.length ) ) {
+                is_dup = true;
+                break;
+              }
+            }
+            slot = (slot+1) & mask;
+          }
+          if( is_dup ) continue;
+          entries[slot] = { hash, mapping_id, pair->key, pair->value };
+        }
+      }
+
+      if( !yaml_key_index_publish( index, table ) ) free( table ); // another task published first, use that one
+      return yaml_key_index_load( index ) != &yaml_key_index_t::none;
+    }
+
+
+    /*\
+     * @brief Key index lookup
+     *
+     * Returns the value node matching the key in the given mapping, or nullptr.
+     * The mapping must be covered by the index and the index built
+     * (see yaml_key_index_build()).
+     *
+    \*/
+    yaml_node_t* yaml_key_index_find( yaml_document_t* document, yaml_key_index_t* index, yaml_node_t* mapping, const char* str, size_t len )
+    {
+      return yaml_key_index_find( document, index, mapping, str, len, yaml_key_hash( str, len ) );
+    }
+
+
+    yaml_node_t* yaml_key_index_find( yaml_document_t* document, yaml_key_index_t* index, yaml_node_t* mapping, const char* str, size_t len, uint32_t key_hash )
+    {
+      const yaml_key_index_t::table_t* table = yaml_key_index_load( index );
+      if( !table || !table->entries ) return nullptr;
+
+      int mapping_id = mapping - document->nodes.start + 1;
+      uint32_t hash = yaml_key_hash( mapping_id, key_hash );
+      size_t slot = hash & table->mask;
+      while( table->entries[slot].hash != 0 ) {
+        const auto &entry = table->entries[slot];
+        if( entry.hash == hash && entry.mapping == mapping_id ) {
+          yaml_node_t *key = yaml_document_get_node(document, entry.key);
+          if( utf8_equal( str, len, (const char*)key->data.scalar.value, key->data.scalar.length ) ) {
+            return yaml_document_get_node(document, entry.value);
+          }
+        }
+        slot = (slot+1) & table->mask;
+      }
+      return nullptr;
+    }
+
+
+    /*\
+     * @brief Compile a gettext path
+     *
+     * Same splitting rules as YAMLNode::gettext(): empty segments are
+     * ignored, a path without delimiter is a single key lookup.
+     *
+    \*/
+    yaml_path_t::yaml_path_t( const char* _path, char delimiter ) :
+      path( _path ? _path : "" ),
+      keys( path ),
+      keys_only( strchr( path.c_str(), delimiter ) == NULL )
+    {
+      if( keys_only ) {
+        segments.push_back( { 0, keys.size(), yaml_key_hash( keys.data(), keys.size() ), -1 } );
+        return;
+      }
+      size_t pos = 0;
+      while( pos < keys.size() ) {
+        size_t end = keys.find( delimiter, pos );
+        if( end == std::string::npos ) end = keys.size();
+        else keys[end] = '\0';
+        if( end > pos ) segments.push_back( { pos, end-pos, yaml_key_hash( keys.data()+pos, end-pos ), atoi( keys.data()+pos ) } );
+        pos = end+1;
+      }
+    }
+
+
     /*\
      * @brief Confirm a string only contains one given char
      *
@@ -110,6 +578,127 @@ namespace YAML
     };
 
 
+    // bytes_out accounting, no-op unless libyaml is built with YAML_ENABLE_STATS
+    static inline void yaml_stats_out( size_t size )
+    {
+      if( yaml_stats_t* stats = yaml_get_stats() ) stats->bytes_out += size;
+    }
+
+
+    /*\
+     * @brief Buffered output sink
+     *
+     * Serializers write through this buffer instead of calling Stream::printf()
+     * for every token, the destination stream receives YAML_OUTPUT_BUFFER_SIZE blocks.
+     *
+    \*/
+    struct yaml_output_buffer_t
+    {
+      Stream* stream;
+      size_t len = 0;
+      char buf[YAML_OUTPUT_BUFFER_SIZE];
+
+      yaml_output_buffer_t( Stream* _stream ) : stream(_stream) {}
+      ~yaml_output_buffer_t() { flush(); }
+
+      void flush()
+      {
+        if( len == 0 ) return;
+        stream->write( (const uint8_t*)buf, len );
+        yaml_stats_out( len );
+        len = 0;
+      }
+
+      size_t write( const char* str, size_t size )
+      {
+        if( len + size > sizeof(buf) ) {
+          flush();
+          if( size >= sizeof(buf) ) { // too big for the buffer, bypass it
+            stream->write( (const uint8_t*)str, size );
+            yaml_stats_out( size );
+            return size;
+          }
+        }
+        memcpy( buf+len, str, size );
+        len += size;
+        return size;
+      }
+
+      size_t write( char c )
+      {
+        if( len == sizeof(buf) ) flush();
+        buf[len++] = c;
+        return 1;
+      }
+
+      size_t print( const char* str ) { return write( str, strlen(str) ); }
+
+      void discard() { len = 0; } // drops what hasn't been flushed yet
+    };
+
+
+    /*\
+     * @brief Binary snapshot format
+     *
+     * Relocatable image of a loaded yaml_document_t, all offsets are relative:
+     *
+     *   [header][nodes: node_t * nodes][items: int32 * items][pairs: int32 * 2 * pairs][pool: pool_size bytes]
+     *
+     * Sequence and mapping nodes reference a slice of the items/pairs arrays,
+     * scalars and tags reference zero-terminated strings in the pool. Common tags
+     * are stored once at the start of the pool. Native byte order, 4 bytes aligned.
+     *
+    \*/
+    struct yaml_snapshot_t
+    {
+      constexpr static const char magic_id[5] = "YMLS";
+      constexpr static const uint16_t version_id = 1;
+      constexpr static const uint16_t byte_order_id = 0x1234;
+      constexpr static const uint32_t none = 0xffffffffu; // no offset
+
+      struct header_t
+      {
+        char magic[4];          // magic_id
+        uint16_t version;       // version_id
+        uint16_t byte_order;    // byte_order_id
+        uint32_t nodes;         // node_t count
+        uint32_t items;         // sequence items count
+        uint32_t pairs;         // mapping pairs count
+        uint32_t pool_size;     // string pool size
+        uint8_t start_implicit;
+        uint8_t end_implicit;
+        uint16_t reserved;
+      };
+
+      struct node_t
+      {
+        uint8_t type;    // yaml_node_type_t
+        uint8_t style;   // yaml_scalar_style_t, yaml_sequence_style_t or yaml_mapping_style_t
+        uint16_t reserved;
+        uint32_t tag;    // pool offset, none when untagged
+        uint32_t data;   // scalar: pool offset, sequence: first item, mapping: first pair
+        uint32_t length; // scalar: value length, sequence: items count, mapping: pairs count
+      };
+
+      static const char* const* tags()
+      {
+        static const char* const common_tags[] = {
+          YAML_STR_TAG, YAML_SEQ_TAG, YAML_MAP_TAG, YAML_INT_TAG, YAML_FLOAT_TAG,
+          YAML_BOOL_TAG, YAML_NULL_TAG, YAML_TIMESTAMP_TAG, nullptr
+        };
+        return common_tags;
+      }
+
+      static size_t image_size( const header_t *header )
+      {
+        return sizeof(header_t) + (size_t)header->nodes*sizeof(node_t) + (size_t)header->items*sizeof(int32_t)
+             + (size_t)header->pairs*2*sizeof(int32_t) + header->pool_size;
+      }
+    };
+
+    constexpr const char yaml_snapshot_t::magic_id[5]; // odr-used by memcmp/memcpy, needs a definition before C++17
+
+
     /*\
      * @brief YAML Traverser
      *
@@ -120,7 +709,8 @@ namespace YAML
     {
       yaml_document_t* document;
       yaml_node_t* node;
-      Stream* stream;
+      yaml_output_buffer_t* out;
+      const yaml_serializer_context_t* ctx;
       YAMLNode::Type type;
       int depth;
     };
@@ -161,90 +751,303 @@ namespace YAML
     }
 
 
-    String _indent_str; // used by indent();
-
     /*\
-     * @brief Indentation string builder
+     * @brief Indentation table
      *
-     * Creates a string with multiple occurences of a given char array.
+     * A read-only run of identical indentation chars, any indentation is
+     * written as a prefix of it, longer ones as repeated slices: no allocation
+     * and no mutation when serializing.
      *
     \*/
-    const char* indent( int size, const char* indstr )
+    struct yaml_indent_table_t
     {
-      if( size<=0 ) return "";
-      _indent_str = "";
-      for( int i=0;i<size;i++ ) _indent_str += indstr;
-      return _indent_str.c_str();
-    }
+      char table[YAML_INDENT_TABLE_SIZE+1];
+
+      yaml_indent_table_t( char c )
+      {
+        memset( table, c, YAML_INDENT_TABLE_SIZE );
+        table[YAML_INDENT_TABLE_SIZE] = '\0';
+      }
+
+      size_t write( yaml_output_buffer_t* out, size_t len ) const
+      {
+        size_t bytes_out = 0;
+        while( len > 0 ) { // runs longer than the table are written in table-sized slices
+          size_t slice = len > YAML_INDENT_TABLE_SIZE ? YAML_INDENT_TABLE_SIZE : len;
+          bytes_out += out->write( table, slice );
+          len -= slice;
+        }
+        return bytes_out;
+      }
+    };
+
+
+    static const yaml_indent_table_t _indent_spaces( YAML_SCALAR_SPACE[0] );
+    static const yaml_indent_table_t _indent_tabs( JSON_SCALAR_TAB[0] );
 
+    // JSON indentation as set by setJSONIndent(), copied into each serializer context
+    static char   _json_indent_char  = JSON_SCALAR_TAB[0];
+    static size_t _json_indent_width = 1;
 
     // array or object index (prefixed by a stroke) translated to indent level
     #define YAML_INDEX_STROKE "- "
-    String _index_str;
+
 
     /*\
-     * @brief Indentation string builder
+     * @brief Serializer context
      *
-     * Creates a string with multiple occurences of a given char array, prefixed by a stroke.
-     * Friend of indent() function.
+     * Formatting settings of a single serialization, copied from the defaults
+     * when the serialization starts and passed along the traversal, so that
+     * concurrent serializations (or a setter called meanwhile) don't step on
+     * each other.
      *
     \*/
-    const char* index()
+    struct yaml_serializer_context_t
     {
-      if( YAML::YAMLIndentDepth <= 2 ) return YAML_INDEX_STROKE;
-      String current_indent = _indent_str; // memoize _indent_str as it'll be reset by the next call
-      _index_str = String( indent(YAML::YAMLIndentDepth-2, " ") ) + String( YAML_INDEX_STROKE );
-      _indent_str = current_indent; // restore _indent_str
-      return _index_str.c_str();
-    }
+      int folding_depth; // JSON objects deeper than this are written inline, -1 = minified
+      size_t yaml_width; // spaces per YAML indent level
+      char json_char;    // JSON indentation char (space or tab)
+      size_t json_width; // JSON indentation chars per level
+
+      size_t indent( yaml_output_buffer_t* out, int level, OutputFormat_t format ) const
+      {
+        if( level<=0 ) return 0;
+        if( format==OUTPUT_YAML ) return _indent_spaces.write( out, level*yaml_width );
+        return ( json_char=='\t' ? _indent_tabs : _indent_spaces ).write( out, level*json_width );
+      }
+
+      // sequence item stroke, padded to the YAML indentation width
+      size_t index( yaml_output_buffer_t* out ) const
+      {
+        size_t bytes_out = _indent_spaces.write( out, yaml_width-2 );
+        return bytes_out + out->write( YAML_INDEX_STROKE, sizeof(YAML_INDEX_STROKE)-1 );
+      }
+    };
 
 
     /*\
-     * @brief String content test on truthy value
+     * @brief Serializer context factory
      *
-     * YAML is very inclusive with booleans :-)
-     * https://yaml.org/type/bool.html
+     * Copies the indentation settings and picks the folding depth for the
+     * given output format, without altering the defaults set by
+     * setYAMLIndent()/setJSONIndent().
      *
     \*/
-    bool string_has_truthy_value( String &_scalar )
+    yaml_serializer_context_t CreateSerializerContext( OutputFormat_t format )
     {
-      return _scalar == "y"    ||  _scalar == "Y"    ||  _scalar == "yes" || _scalar == "Yes" || _scalar == "YES"
-        ||  _scalar == "true" ||  _scalar == "True" ||  _scalar == "TRUE"
-        ||  _scalar == "on"   ||  _scalar == "On"   ||  _scalar == "ON";
+      int folding_depth = -1; // OUTPUT_JSON
+      if( format != OUTPUT_JSON ) {
+        folding_depth = YAML::JSONFoldindDepth<0 ? JSON_FOLDING_DEPTH : YAML::JSONFoldindDepth;
+      }
+      return { folding_depth, (size_t)YAML::YAMLIndentDepth, _json_indent_char, _json_indent_width };
     }
 
 
     /*\
-     * @brief String content test on truthy value
+     * @brief Bool/null word test
      *
-     * YAML is very inclusive with booleans :-)
-     * https://yaml.org/type/bool.html
+     * Matches the lowercase, Capitalized or UPPERCASE form of 'lower',
+     * 'len' is the length of both strings.
      *
     \*/
-    bool string_has_falsy_value( String &_scalar )
+    static bool yaml_scalar_word_is( const char* scalar, const char* lower, size_t len )
     {
-      return _scalar == "n"     ||  _scalar == "N"     ||  _scalar == "no" || _scalar == "No" || _scalar == "NO"
-        ||  _scalar == "false" ||  _scalar == "False" ||  _scalar == "FALSE"
-        ||  _scalar == "off"   ||  _scalar == "Off"   ||  _scalar == "OFF";
+      if( memcmp( scalar+1, lower+1, len-1 ) == 0 ) {
+        return scalar[0] == lower[0] || scalar[0] == lower[0]-32;
+      }
+      for( size_t i=0; i<len; i++ ) {
+        if( scalar[i] != lower[i]-32 ) return false;
+      }
+      return true;
     }
 
 
     /*\
-     * @brief String content test on truthy/falsy value
+     * @brief Number syntax test
      *
-     * YAML is very inclusive with booleans :-)
-     * https://yaml.org/type/bool.html
+     * Accepts exactly what strtod() fully consumes: leading whitespace,
+     * sign, decimal or hexadecimal digits with optional fraction and exponent,
+     * inf/infinity and nan. Only 'length' bytes are read.
+     * Unsigned '0x...' values are classified HEX, signed ones INT or FLOAT.
      *
     \*/
-    bool string_has_bool_value( String &_scalar, bool *value_out )
+    static yaml_scalar_class_t yaml_scalar_number_class( const char* scalar, size_t length )
     {
-      bool has_truthy = string_has_truthy_value(_scalar);
-      bool has_falsy  = string_has_falsy_value(_scalar);
-      if( has_truthy || has_falsy ) {
-        *value_out = has_truthy;
-        return true;
+      const char* p = scalar;
+      const char* end = scalar + length;
+      while( p<end && (*p==' ' || (*p>='\t' && *p<='\r')) ) p++;
+      if( p<end && (*p=='+' || *p=='-') ) p++;
+      if( p == end ) return YAML_SCALAR_CLASS_STRING;
+
+      if( (*p|0x20) == 'i' ) {
+        if( end-p < 3 || strncasecmp( p, "inf", 3 ) != 0 ) return YAML_SCALAR_CLASS_STRING;
+        p += 3;
+        if( end-p >= 5 && strncasecmp( p, "inity", 5 ) == 0 ) p += 5;
+        return p != end ? YAML_SCALAR_CLASS_STRING : YAML_SCALAR_CLASS_FLOAT;
       }
-      return false;
+      if( (*p|0x20) == 'n' ) {
+        if( end-p < 3 || strncasecmp( p, "nan", 3 ) != 0 ) return YAML_SCALAR_CLASS_STRING;
+        p += 3;
+        if( p<end && *p == '(' ) {
+          const char* q = p+1;
+          while( q<end && ( isalnum((unsigned char)*q) || *q=='_' ) ) q++;
+          if( q<end && *q == ')' ) p = q+1;
+        }
+        return p != end ? YAML_SCALAR_CLASS_STRING : YAML_SCALAR_CLASS_FLOAT;
+      }
+
+      bool is_hex = end-p >= 3 && p[0]=='0' && (p[1]|0x20)=='x'
+                 && ( isxdigit((unsigned char)p[2]) || (p[2]=='.' && end-p >= 4 && isxdigit((unsigned char)p[3])) );
+      bool is_float = false;
+      size_t digits = 0;
+      if( is_hex ) {
+        p += 2;
+        while( p<end && isxdigit((unsigned char)*p) ) { p++; digits++; }
+        if( p<end && *p == '.' ) { p++; is_float = true; while( p<end && isxdigit((unsigned char)*p) ) { p++; digits++; } }
+      } else {
+        while( p<end && *p>='0' && *p<='9' ) { p++; digits++; }
+        if( p<end && *p == '.' ) { p++; is_float = true; while( p<end && *p>='0' && *p<='9' ) { p++; digits++; } }
+      }
+      if( digits == 0 ) return YAML_SCALAR_CLASS_STRING;
+      // the exponent is only consumed when followed by digits
+      if( p<end && (*p|0x20) == (is_hex ? 'p' : 'e') ) {
+        const char* q = p+1;
+        if( q<end && (*q=='+' || *q=='-') ) q++;
+        if( q<end && *q>='0' && *q<='9' ) {
+          while( q<end && *q>='0' && *q<='9' ) q++;
+          p = q;
+          is_float = true;
+        }
+      }
+      if( p != end ) return YAML_SCALAR_CLASS_STRING;
+      // NOTE: '0x...' prefixed values are kept apart, JSON output keeps them as strings
+      if( is_hex && scalar[0]=='0' ) return YAML_SCALAR_CLASS_HEX;
+      return is_float ? YAML_SCALAR_CLASS_FLOAT : YAML_SCALAR_CLASS_INT;
+    }
+
+
+    /*\
+     * @brief Scalar content classifier
+     *
+     * Single pass and allocation free: null and truthy/falsy words are only
+     * recognized in plain style, numbers in any style.
+     * YAML is very inclusive with booleans :-)
+     * https://yaml.org/type/bool.html
+     *
+    \*/
+    yaml_scalar_class_t yaml_scalar_classify( const char* scalar, size_t length, yaml_scalar_style_t style )
+    {
+      if( style == YAML_PLAIN_SCALAR_STYLE ) {
+        switch( length ) {
+          case 0: return YAML_SCALAR_CLASS_NULL;
+          case 1:
+            switch( scalar[0] ) {
+              case 'y': case 'Y': return YAML_SCALAR_CLASS_TRUE;
+              case 'n': case 'N': return YAML_SCALAR_CLASS_FALSE;
+              case '~':           return YAML_SCALAR_CLASS_NULL;
+              default: break;
+            }
+          break;
+          case 2:
+            switch( scalar[0] ) {
+              case 'o': case 'O': if( yaml_scalar_word_is( scalar, "on", 2 ) )  return YAML_SCALAR_CLASS_TRUE; break;
+              case 'n': case 'N': if( yaml_scalar_word_is( scalar, "no", 2 ) )  return YAML_SCALAR_CLASS_FALSE; break;
+              default: break;
+            }
+          break;
+          case 3:
+            switch( scalar[0] ) {
+              case 'y': case 'Y': if( yaml_scalar_word_is( scalar, "yes", 3 ) ) return YAML_SCALAR_CLASS_TRUE; break;
+              case 'o': case 'O': if( yaml_scalar_word_is( scalar, "off", 3 ) ) return YAML_SCALAR_CLASS_FALSE; break;
+              default: break;
+            }
+          break;
+          case 4:
+            switch( scalar[0] ) {
+              case 't': case 'T': if( yaml_scalar_word_is( scalar, "true", 4 ) ) return YAML_SCALAR_CLASS_TRUE; break;
+              case 'n': case 'N': if( yaml_scalar_word_is( scalar, "null", 4 ) ) return YAML_SCALAR_CLASS_NULL; break;
+              default: break;
+            }
+          break;
+          case 5:
+            if( (scalar[0]=='f' || scalar[0]=='F') && yaml_scalar_word_is( scalar, "false", 5 ) ) return YAML_SCALAR_CLASS_FALSE;
+          break;
+          default: break;
+        }
+      }
+      return yaml_scalar_number_class( scalar, length );
+    }
+
+
+    /*\
+     * @brief Scalar node classifier
+     *
+     * Same as yaml_scalar_classify(), uses the class cached in the node by
+     * yaml_document_classify() if any. Never writes to the node, so shared
+     * documents can be serialized concurrently.
+     *
+    \*/
+    yaml_scalar_class_t yaml_node_classify( yaml_node_t * yamlNode )
+    {
+      if( yamlNode->data.scalar.content_class == 0 ) {
+        return yaml_scalar_classify( SCALAR_c(yamlNode), yamlNode->data.scalar.length, yamlNode->data.scalar.style );
+      }
+      return (yaml_scalar_class_t)(yamlNode->data.scalar.content_class - 1);
+    }
+
+
+    /*\
+     * @brief Scalar classes cache filler
+     *
+     * Caches the class of every scalar node, called by the loaders
+     * before the document is shared.
+     *
+    \*/
+    void yaml_document_classify( yaml_document_t* document )
+    {
+      for( yaml_node_t *node = document->nodes.start; node < document->nodes.top; node++ ) {
+        if( node->type != YAML_SCALAR_NODE ) continue;
+        node->data.scalar.content_class = 1 + yaml_scalar_classify( SCALAR_c(node), node->data.scalar.length, node->data.scalar.style );
+      }
+    }
+
+
+    /*\
+     * @brief String content test on truthy value
+     *
+     * YAML is very inclusive with booleans :-)
+     * https://yaml.org/type/bool.html
+     *
+    \*/
+    bool string_has_truthy_value( String &_scalar )
+    {
+      return yaml_scalar_classify( _scalar.c_str(), _scalar.length(), YAML_PLAIN_SCALAR_STYLE ) == YAML_SCALAR_CLASS_TRUE;
+    }
+
+
+    /*\
+     * @brief String content test on truthy value
+     *
+     * YAML is very inclusive with booleans :-)
+     * https://yaml.org/type/bool.html
+     *
+    \*/
+    bool string_has_falsy_value( String &_scalar )
+    {
+      return yaml_scalar_classify( _scalar.c_str(), _scalar.length(), YAML_PLAIN_SCALAR_STYLE ) == YAML_SCALAR_CLASS_FALSE;
+    }
+
+
+    /*\
+     * @brief String content test on truthy/falsy value
+     *
+     * YAML is very inclusive with booleans :-)
+     * https://yaml.org/type/bool.html
+     *
+    \*/
+    bool string_has_bool_value( String &_scalar, bool *value_out )
+    {
+      return yaml_scalar_is_bool( _scalar.c_str(), YAML_PLAIN_SCALAR_STYLE, value_out );
     }
 
 
@@ -257,361 +1060,2264 @@ namespace YAML
     \*/
     bool yaml_node_is_bool( yaml_node_t * yamlNode, bool *value_out )
     {
-      switch (yamlNode->data.scalar.style) {
-        case YAML_PLAIN_SCALAR_STYLE:
+      switch( yaml_node_classify( yamlNode ) ) {
+        case YAML_SCALAR_CLASS_TRUE:  *value_out = true;  return true;
+        case YAML_SCALAR_CLASS_FALSE: *value_out = false; return true;
+        default: return false;
+      }
+    }
+
+
+    /*\
+     * @brief Scalar content test on truthy/falsy value
+     *
+     * Same as yaml_node_is_bool() but usable on parser events.
+     *
+    \*/
+    bool yaml_scalar_is_bool( const char* scalar, yaml_scalar_style_t style, bool *value_out )
+    {
+      switch( yaml_scalar_classify( scalar, strlen(scalar), style ) ) {
+        case YAML_SCALAR_CLASS_TRUE:  *value_out = true;  return true;
+        case YAML_SCALAR_CLASS_FALSE: *value_out = false; return true;
+        default: return false;
+      }
+    }
+
+
+    /*\
+     * @brief YAML multiline entities escaper for YAML output
+     *
+     * Helper for serializers.
+     * Unescaped runs of characters are copied in one go.
+     *
+    \*/
+    void yaml_multiline_escape_string( yaml_output_buffer_t* out, const char* str, size_t length, size_t *bytes_out, size_t depth, const yaml_serializer_context_t* ctx )
+    {
+      if( length == 0 ) return;
+      size_t i;
+      size_t run = 0; // start of the pending unescaped run
+      char c;
+      char l = '\0';
+      bool has_multiline = memchr( str, '\n', length ) != nullptr;
+      bool has_ending_lf = str[length-1] == '\n';
+      if( has_ending_lf ) length--; // remove trailing lf
+      if( has_multiline ) {
+        *bytes_out += out->write( '|' );
+        if( !has_ending_lf ) *bytes_out += out->write( '-' );
+        *bytes_out += out->write( '\n' );
+        *bytes_out += ctx->indent( out, depth, OUTPUT_YAML );
+      }
+
+      for (i = 0; i < length; i++) {
+        c = str[i];
+        const char* escaped = nullptr;
+        if( c== '\r' || c=='\n' ) {
+          if( l != '\\' && has_multiline ) { // unescaped \r or \n
+            *bytes_out += out->write( str+run, i-run );
+            run = i+1;
+            if(c == '\r') *bytes_out += 1;  // ignore \r
+            else { // print CRLF
+              *bytes_out += out->write( '\n' );
+              *bytes_out += ctx->indent( out, depth, OUTPUT_YAML );
+            }
+          } else {
+            escaped = (c == '\n') ? "\\n" : "\\r";
+          }
+        } else if( !has_multiline ) {
+          if      (c == '\\') escaped = "\\\\";
+          else if (c == '\0') escaped = "\\0";
+          else if (c == '\b') escaped = "\\b";
+          else if (c == '\t') escaped = "\\t";
+        }
+        if( escaped ) {
+          *bytes_out += out->write( str+run, i-run );
+          *bytes_out += out->write( escaped, 2 );
+          run = i+1;
+        }
+        l = c; // memoize last char to spot escaped entities
+      }
+      *bytes_out += out->write( str+run, length-run );
+    }
+
+
+    /*\
+     * @brief YAML multiline entities escaper for YAML output
+     *
+     * Helper for serializers.
+     *
+    \*/
+    void yaml_multiline_escape_string( Stream* stream, const char* str, size_t length, size_t *bytes_out, size_t depth )
+    {
+      yaml_serializer_context_t ctx = CreateSerializerContext( OUTPUT_YAML );
+      yaml_output_buffer_t out( stream );
+      yaml_multiline_escape_string( &out, str, length, bytes_out, depth, &ctx );
+    }
+
+
+    /*\
+     * @brief YAML multiline entities escaper for YAML output
+     *
+     * Helper for serializers.
+     *
+    \*/
+    void yaml_multiline_escape_string( yaml_output_buffer_t* out, yaml_node_t *node, size_t *bytes_out, size_t depth, const yaml_serializer_context_t* ctx )
+    {
+      yaml_multiline_escape_string( out, SCALAR_c(node), strlen(SCALAR_c(node)), (const char*)node->tag, node->data.scalar.style, bytes_out, depth, ctx );
+    }
+
+
+    /*\
+     * @brief YAML multiline entities escaper for YAML output
+     *
+     * Same as above but usable on parser events, a NULL or "!" tag
+     * stands for the default scalar tag.
+     *
+    \*/
+    void yaml_multiline_escape_string( yaml_output_buffer_t* out, const char* str, size_t length, const char* tag, yaml_scalar_style_t style, size_t *bytes_out, size_t depth, const yaml_serializer_context_t* ctx )
+    {
+      // int plain_implicit = (strcmp((char *)node->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
+      bool quoted_implicit = ( !tag || strcmp(tag, "!") == 0 || strcmp(tag, YAML_DEFAULT_SCALAR_TAG) == 0 );
+      char quote = 0;
+      if( quoted_implicit ) {
+        switch( style )
         {
-          String _scalar = String( SCALAR_s(yamlNode) );
-          if( string_has_bool_value(_scalar, value_out) ) {
-            return true;
+          case YAML_SINGLE_QUOTED_SCALAR_STYLE: quote = '\''; break;
+          case YAML_DOUBLE_QUOTED_SCALAR_STYLE: quote = '"'; break;
+          default: quoted_implicit = false; break;
+        }
+      }
+      if( quoted_implicit ) *bytes_out+= out->write(quote);
+      yaml_multiline_escape_string(out, str, length, bytes_out, depth, ctx );
+      if( quoted_implicit ) *bytes_out+= out->write(quote);
+    }
+
+
+
+
+    /*\
+     * @brief JSON escape sequence of a character
+     *
+     * Returns the two characters escape sequence, or NULL when
+     * the character can be written as is.
+     *
+    \*/
+    static inline const char* yaml_escape_sequence( char c )
+    {
+      switch( c ) {
+        case '\\': return "\\\\";
+        case '\0': return "\\0";
+        case '\b': return "\\b";
+        case '\n': return "\\n";
+        case '\r': return "\\r";
+        case '\t': return "\\t";
+        case '"':  return "\\\"";
+        default:   return nullptr;
+      }
+    }
+
+
+    /*\
+     * @brief Next character needing a JSON escape sequence
+     *
+     * Returns the offset of the first escapable character at or after 'from',
+     * or 'length' when there is none. Scans 16 bytes at a time with SSE2/NEON,
+     * a machine word at a time otherwise.
+     *
+    \*/
+    static size_t yaml_escape_find( const char* str, size_t from, size_t length )
+    {
+      size_t i = from;
+      #if defined YAML_SIMD_SSE2
+        const __m128i backslash = _mm_set1_epi8('\\'), quote = _mm_set1_epi8('"'), nul = _mm_setzero_si128();
+        const __m128i bs = _mm_set1_epi8('\b'), tab = _mm_set1_epi8('\t'), lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+        for( ; i+16 <= length; i += 16 ) {
+          __m128i v = _mm_loadu_si128( (const __m128i*)(str+i) );
+          __m128i m = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8(v, backslash), _mm_cmpeq_epi8(v, quote) ),
+                                    _mm_or_si128( _mm_cmpeq_epi8(v, nul), _mm_cmpeq_epi8(v, bs) ) );
+          m = _mm_or_si128( m, _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8(v, tab), _mm_cmpeq_epi8(v, lf) ), _mm_cmpeq_epi8(v, cr) ) );
+          int mask = _mm_movemask_epi8( m );
+          if( mask ) return i + __builtin_ctz( mask );
+        }
+      #elif defined YAML_SIMD_NEON
+        for( ; i+16 <= length; i += 16 ) {
+          uint8x16_t v = vld1q_u8( (const uint8_t*)str+i );
+          uint8x16_t m = vorrq_u8( vorrq_u8( vceqq_u8(v, vdupq_n_u8('\\')), vceqq_u8(v, vdupq_n_u8('"')) ),
+                                   vorrq_u8( vceqq_u8(v, vdupq_n_u8('\0')), vceqq_u8(v, vdupq_n_u8('\b')) ) );
+          m = vorrq_u8( m, vorrq_u8( vorrq_u8( vceqq_u8(v, vdupq_n_u8('\t')), vceqq_u8(v, vdupq_n_u8('\n')) ), vceqq_u8(v, vdupq_n_u8('\r')) ) );
+          // narrow to 4 bits per byte to get a scalar mask
+          uint64_t mask = vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8(m), 4 ) ), 0 );
+          if( mask ) return i + ( __builtin_ctzll( mask ) >> 2 );
+        }
+      #else
+        // SWAR: flags words holding a '\\', a '"' or a byte below 0x0E (all other escapable
+        // characters), those are then checked byte per byte
+        const size_t ones  = (size_t)-1 / 0xFF;
+        const size_t highs = ones * 0x80;
+        for( ; i+sizeof(size_t) <= length; i += sizeof(size_t) ) {
+          size_t w;
+          memcpy( &w, str+i, sizeof(w) );
+          size_t b = w ^ (ones * '\\');
+          size_t q = w ^ (ones * '"');
+          size_t hit = ( (b - ones) & ~b ) | ( (q - ones) & ~q ) | ( (w - ones * 0x0E) & ~w );
+          if( hit & highs ) {
+            for( size_t j=i; j<i+sizeof(size_t); j++ ) {
+              if( yaml_escape_sequence( str[j] ) ) return j;
+            }
           }
         }
-        break;
-        case YAML_SINGLE_QUOTED_SCALAR_STYLE: /*YAML_LOG_e(" '")*/; break;
-        case YAML_DOUBLE_QUOTED_SCALAR_STYLE: /*YAML_LOG_e(" \"")*/; break;
-        case YAML_LITERAL_SCALAR_STYLE: /*YAML_LOG_e(" |")*/; break;
-        case YAML_FOLDED_SCALAR_STYLE: /*YAML_LOG_e(" >")*/; break;
-        case YAML_ANY_SCALAR_STYLE: /*abort(); */ break;
+      #endif
+      for( ; i<length; i++ ) {
+        if( yaml_escape_sequence( str[i] ) ) return i;
+      }
+      return length;
+    }
+
+
+    /*\
+     * @brief YAML string escaper for JSON output
+     *
+     * Helper for serializers when escaping to JSON.
+     * Unescaped runs of characters are located with yaml_escape_find()
+     * and copied in one go.
+     *
+    \*/
+    void yaml_escape_quoted_string( yaml_output_buffer_t* out, const char* str, size_t length, size_t *bytes_out )
+    {
+      size_t run = 0; // start of the pending unescaped run
+      for( size_t i = yaml_escape_find( str, 0, length ); i < length; i = yaml_escape_find( str, run, length ) ) {
+        *bytes_out += out->write( str+run, i-run );
+        *bytes_out += out->write( yaml_escape_sequence( str[i] ), 2 );
+        run = i+1;
+      }
+      *bytes_out += out->write( str+run, length-run );
+    }
+
+
+    /*\
+     * @brief YAML string escaper for JSON output
+     *
+     * Helper for serializers when escaping to JSON.
+     *
+    \*/
+    void yaml_escape_quoted_string( Stream* stream, const char* str, size_t length, size_t *bytes_out )
+    {
+      yaml_output_buffer_t out( stream );
+      yaml_escape_quoted_string( &out, str, length, bytes_out );
+    }
+
+
+    /*\
+     * @brief Quoted scalar test
+     *
+     * True when a quoted scalar has the default scalar tag,
+     * a NULL or "!" tag stands for the default scalar tag.
+     *
+    \*/
+    static bool scalar_is_quoted_string( const char* tag, yaml_scalar_style_t style )
+    {
+      if( style != YAML_SINGLE_QUOTED_SCALAR_STYLE && style != YAML_DOUBLE_QUOTED_SCALAR_STYLE )
+        return false;
+      return !tag || strcmp(tag, "!") == 0 || strcmp(tag, YAML_DEFAULT_SCALAR_TAG) == 0;
+    }
+
+
+    /*\
+     * @brief Scalar class checker for JSON output.
+     *
+     * Null, hexadecimal and string values are quoted, booleans and numbers aren't.
+     *
+    \*/
+    static bool scalar_class_needs_quote( yaml_scalar_class_t scalar_class )
+    {
+      switch( scalar_class ) {
+        case YAML_SCALAR_CLASS_TRUE:
+        case YAML_SCALAR_CLASS_FALSE:
+        case YAML_SCALAR_CLASS_INT:
+        case YAML_SCALAR_CLASS_FLOAT:
+          return false;
+        default: // null is kept as a string for backwards compatibility
+          return true;
+      }
+    }
+
+
+    /*\
+     * @brief Node content checker for JSON output.
+     *
+     * Checks if scalar contents needs to be quoted
+     * when serializing to JSON.
+     *
+    \*/
+    bool scalar_needs_quote( yaml_node_t *node )
+    {
+      if( node->type != YAML_SCALAR_NODE )
+        return false;
+      if( scalar_is_quoted_string( (const char*)node->tag, node->data.scalar.style ) )
+        return true;
+      return scalar_class_needs_quote( yaml_node_classify( node ) );
+    }
+
+
+    /*\
+     * @brief Scalar content checker for JSON output.
+     *
+     * Same as scalar_needs_quote(node) but usable on parser events,
+     * a NULL or "!" tag stands for the default scalar tag.
+     *
+    \*/
+    bool scalar_needs_quote( const char* scalar, const char* tag, yaml_scalar_style_t style )
+    {
+      if( scalar_is_quoted_string( tag, style ) )
+        return true;
+      return scalar_class_needs_quote( yaml_scalar_classify( scalar, strlen(scalar), style ) );
+    }
+
+
+    /*\
+     * @brief Growable frame stack
+     *
+     * The first YAML_STREAM_MAX_DEPTH frames need no allocation, deeper
+     * ones are kept on the heap. Accessing a frame past the end grows the
+     * stack, so frame pointers must not be kept across a deeper access.
+     *
+    \*/
+    template <typename frame_t> struct yaml_frame_stack_t
+    {
+      frame_t frames[YAML_STREAM_MAX_DEPTH];
+      std::vector<frame_t> more; // frames YAML_STREAM_MAX_DEPTH and up
+
+      frame_t& operator [] ( size_t index )
+      {
+        if( index < YAML_STREAM_MAX_DEPTH ) return frames[index];
+        index -= YAML_STREAM_MAX_DEPTH;
+        if( more.size() <= index ) more.resize( index+1 );
+        return more[index];
+      }
+    };
+
+
+    /*\
+     * @brief Event driven YAML/JSON writer
+     *
+     * Transcodes libyaml parser events to JSON or YAML with the same layout
+     * as YAMLNode::toJSON() and YAMLNode::toYAML(), without building a document
+     * tree: memory usage depends on the nesting depth, not on the document size.
+     * Aliases can't be resolved without keeping the anchored nodes and
+     * are rejected.
+     *
+    \*/
+    struct yaml_event_writer_t
+    {
+      struct frame_t
+      {
+        YAMLNode::Type type;      // Sequence or Map
+        YAMLNode::Type nest_type; // parent type
+        int depth;
+        int count;                // items/pairs written so far
+        bool needs_folding;
+        bool expects_key;
+      };
+
+      yaml_output_buffer_t* out;
+      const yaml_serializer_context_t* ctx;
+      OutputFormat_t format;
+      yaml_frame_stack_t<frame_t> stack;
+      int top = -1;        // current frame index
+      int skip_items = 0;  // items left to skip (invalid key + its value)
+      int skip_depth = 0;  // nesting level inside skipped items
+      size_t bytes_out = 0;
+
+      yaml_event_writer_t( yaml_output_buffer_t* _out, const yaml_serializer_context_t* _ctx, OutputFormat_t _format ) : out(_out), ctx(_ctx), format(_format) {}
+
+      // opens a value in the current frame, returns its depth
+      int value_depth( bool is_mapping, YAMLNode::Type *nest_type )
+      {
+        *nest_type = YAMLNode::Type::Null;
+        if( top < 0 ) return 0;
+        frame_t *parent = &stack[top];
+        *nest_type = parent->type;
+        if( parent->type == YAMLNode::Type::Sequence ) {
+          if( parent->count++ > 0 && format != OUTPUT_YAML ) bytes_out += out->write(", ", 2);
+          return is_mapping ? parent->depth+1 : parent->depth-1;
+        }
+        parent->expects_key = true; // next event in this map is a key
+        return parent->depth+1;
+      }
+
+      void push( YAMLNode::Type type, YAMLNode::Type nest_type, int depth, bool needs_folding )
+      {
+        stack[++top] = { type, nest_type, depth, 0, needs_folding, true };
+      }
+
+      // consumes events of skipped items, returns false when done skipping
+      bool skip( yaml_event_t *event )
+      {
+        switch( event->type ) {
+          case YAML_SEQUENCE_START_EVENT:
+          case YAML_MAPPING_START_EVENT: skip_depth++; return true;
+          case YAML_SEQUENCE_END_EVENT:
+          case YAML_MAPPING_END_EVENT:   skip_depth--; break;
+          default: break;
+        }
+        if( skip_depth == 0 ) skip_items--;
+        return skip_items > 0;
+      }
+
+      bool write_key( yaml_event_t *event )
+      {
+        frame_t *map = &stack[top];
+        bool is_first = ( map->count++ == 0 );
+        if( event->type != YAML_SCALAR_EVENT ) {
+          YAML_LOG_e("Mapping key is not scalar (line %lu).", event->start_mark.line);
+          if( is_first && format != OUTPUT_YAML ) map->count = 0; // no separator was written
+          skip_items = 2;
+          skip_depth = 0;
+          skip( event );
+          return true;
+        }
+        if( format == OUTPUT_YAML ) {
+          bool is_seqfirst = ( is_first && map->nest_type == YAMLNode::Type::Sequence );
+          int parent_level = map->depth>0 ? map->depth-1 : 0;
+          bytes_out += out->write('\n');
+          bytes_out += ctx->indent( out, is_seqfirst ? parent_level : map->depth, OUTPUT_YAML );
+          if( is_seqfirst ) bytes_out += ctx->index( out );
+          bytes_out += out->write( (const char*)event->data.scalar.value, event->data.scalar.length );
+          bytes_out += out->write(": ", 2);
+        } else {
+          if( !is_first ) {
+            if( !map->needs_folding ) {
+              bytes_out += out->write(",\n", 2);
+              bytes_out += ctx->indent( out, map->depth+1, OUTPUT_JSON );
+            } else {
+              bytes_out += out->write(", ", 2);
+            }
+          }
+          bytes_out += out->write('"');
+          bytes_out += out->write( (const char*)event->data.scalar.value, event->data.scalar.length );
+          bytes_out += out->write("\": ", 3);
+        }
+        map->expects_key = false;
+        return true;
+      }
+
+      void write_scalar( yaml_event_t *event, int depth, YAMLNode::Type nest_type )
+      {
+        const char* scalar = (const char*)event->data.scalar.value;
+        const char* tag    = (const char*)event->data.scalar.tag;
+        size_t length      = event->data.scalar.length;
+        auto style         = event->data.scalar.style;
+        if( format == OUTPUT_YAML ) {
+          if ( nest_type == YAMLNode::Type::Sequence ) {
+            bytes_out += out->write('\n');
+            bytes_out += ctx->indent( out, depth, OUTPUT_YAML );
+            bytes_out += ctx->index( out );
+          }
+          yaml_multiline_escape_string( out, scalar, length, tag, style, &bytes_out, depth, ctx );
+        } else {
+          bool needs_quotes = scalar_needs_quote( scalar, tag, style );
+          if( needs_quotes ) bytes_out += out->write('"');
+          yaml_escape_quoted_string( out, scalar, length, &bytes_out );
+          if( needs_quotes ) bytes_out += out->write('"');
+        }
+      }
+
+      // returns false on error
+      bool write( yaml_event_t *event )
+      {
+        if( skip_items > 0 ) {
+          if( !skip( event ) ) stack[top].expects_key = true;
+          return true;
+        }
+
+        bool is_map_end = event->type == YAML_MAPPING_END_EVENT;
+        if( top >= 0 && stack[top].type == YAMLNode::Type::Map && stack[top].expects_key && !is_map_end ) {
+          return write_key( event );
+        }
+
+        YAMLNode::Type nest_type;
+        int depth;
+
+        switch( event->type ) {
+          case YAML_SCALAR_EVENT:
+            depth = value_depth( false, &nest_type );
+            write_scalar( event, depth, nest_type );
+          break;
+          case YAML_SEQUENCE_START_EVENT:
+            depth = value_depth( false, &nest_type );
+            push( YAMLNode::Type::Sequence, nest_type, depth, false );
+            if( format != OUTPUT_YAML ) bytes_out += out->write('[');
+          break;
+          case YAML_SEQUENCE_END_EVENT:
+            if( format != OUTPUT_YAML ) bytes_out += out->write(']');
+            top--;
+          break;
+          case YAML_MAPPING_START_EVENT:
+          {
+            depth = value_depth( true, &nest_type );
+            bool needs_folding = (depth>ctx->folding_depth);
+            push( YAMLNode::Type::Map, nest_type, depth, needs_folding );
+            if( format != OUTPUT_YAML ) {
+              bytes_out += out->write('{');
+              if( !needs_folding ) {
+                bytes_out += out->write('\n');
+                bytes_out += ctx->indent( out, depth+1, OUTPUT_JSON );
+              }
+            }
+          }
+          break;
+          case YAML_MAPPING_END_EVENT:
+            if( format != OUTPUT_YAML ) {
+              frame_t *map = &stack[top];
+              bool is_seq = ( map->depth>0 && map->nest_type == YAMLNode::Type::Sequence );
+              if( !map->needs_folding ) {
+                bytes_out += out->write('\n');
+                bytes_out += ctx->indent( out, is_seq ? map->depth-1 : map->depth, OUTPUT_JSON );
+              }
+              bytes_out += out->write('}');
+            }
+            top--;
+          break;
+          case YAML_ALIAS_EVENT:
+            YAML_LOG_e("Aliases are not supported when streaming (line %lu).", event->start_mark.line);
+          return false;
+          default: break; // stream/document start/end
+        }
+        return true;
+      }
+    };
+
+
+  };
+
+
+
+  /*\
+   * @brief Set YAML indentation depth
+   *
+   * Minimum indentation is 2 spaces.
+   * Maximum is 16 spaces for retina screens :)
+  \*/
+  void setYAMLIndent( int spaces_per_indent )
+  {
+    if( spaces_per_indent < 2 ) spaces_per_indent = 2;
+    if( spaces_per_indent > MAX_INDENT_DEPTH ) spaces_per_indent = MAX_INDENT_DEPTH;
+    YAMLIndentDepth = spaces_per_indent;
+    YAML_INDENT_STRING = "";
+    for( int i=0;i<spaces_per_indent;i++ ) {
+      YAML_INDENT_STRING += String(YAML_SCALAR_SPACE);
+    }
+  }
+
+
+  /*\
+   * @brief Enable or disable document arenas
+   *
+   * When enabled, documents loaded by YAMLNode::loadString() and
+   * YAMLNode::loadStream() are allocated from a bump-pointer arena made
+   * of 'chunk_size' bytes chunks, and released all at once.
+   * Such documents must not be modified using yaml_document_add_*().
+  \*/
+  void setDocumentArena( size_t chunk_size )
+  {
+    if( chunk_size > 0 && chunk_size < 256 ) chunk_size = 256;
+    DocumentArenaChunkSize = chunk_size;
+  }
+
+
+  /*\
+   * @brief Allocation and throughput counters
+   *
+   * Available when libyaml is built with YAML_ENABLE_STATS, counters are
+   * per-thread and cover libyaml, the document arena and serializers output.
+   *
+  \*/
+  namespace stats
+  {
+    bool enabled()
+    {
+      return yaml_get_stats() != nullptr;
+    }
+
+    yaml_stats_t get()
+    {
+      yaml_stats_t* stats = yaml_get_stats();
+      if( stats ) return *stats;
+      yaml_stats_t empty;
+      memset( &empty, 0, sizeof(empty) );
+      return empty;
+    }
+
+    void reset()
+    {
+      yaml_reset_stats();
+    }
+  };
+
+
+  /*\
+   * @brief Set JSON indentation depth
+   *
+   * Sanitize 'spaces_or_tabs' input var:
+   *  - must have spaces only or tabs only
+   *  - min/max requirements
+   *  - fallback values
+  \*/
+  void setJSONIndent( const char* spaces_or_tabs, int folding_depth )
+  {
+    bool is_valid_str = ( is_filled_with(' ', spaces_or_tabs ) || is_filled_with('\t', spaces_or_tabs ) );
+    if( !is_valid_str ) JSON_INDENT_STRING = JSON_SCALAR_TAB;
+    else                JSON_INDENT_STRING = String( spaces_or_tabs );
+    _json_indent_char  = JSON_INDENT_STRING.length()>0 ? JSON_INDENT_STRING[0] : ' ';
+    _json_indent_width = JSON_INDENT_STRING.length(); // any width, indentation is written in slices
+
+    bool is_in_range  = JSON_INDENT_STRING.length() < MAX_INDENT_DEPTH;
+    if( !is_in_range ) {
+      YAML_LOG_w("JSON indent is %u chars wide, folding depth falls back to %d", (unsigned)JSON_INDENT_STRING.length(), JSON_FOLDING_DEPTH );
+      JSONFoldindDepth = JSON_FOLDING_DEPTH;
+    } else {
+      JSONFoldindDepth = folding_depth;
+    }
+  }
+
+
+
+
+
+  /*\
+   * @brief YAML document copier
+   *
+   * Creates a copy of a given document.
+   *
+  \*/
+  int yaml_copy_document(yaml_document_t *dest, yaml_document_t *src)
+  {
+    yaml_node_t *node;
+    yaml_node_item_t *item;
+    yaml_node_pair_t *pair;
+
+    if (!yaml_document_initialize(dest, src->version_directive, src->tag_directives.start, src->tag_directives.end, src->start_implicit, src->end_implicit)) return 0;
+
+    for (node = src->nodes.start; node < src->nodes.top; node ++) {
+      switch (node->type) {
+        case YAML_SCALAR_NODE:   if (!yaml_document_add_scalar(dest, node->tag, node->data.scalar.value, node->data.scalar.length, node->data.scalar.style)) goto _error; break;
+        case YAML_SEQUENCE_NODE: if (!yaml_document_add_sequence(dest, node->tag, node->data.sequence.style)) goto _error; break;
+        case YAML_MAPPING_NODE:  if (!yaml_document_add_mapping(dest, node->tag, node->data.mapping.style)) goto _error; break;
+        default: assert(0); break;
+      }
+    }
+
+    for (node = src->nodes.start; node < src->nodes.top; node ++) {
+      switch (node->type) {
+        case YAML_SEQUENCE_NODE:
+          for (item = node->data.sequence.items.start; item < node->data.sequence.items.top; item ++) {
+            if (!yaml_document_append_sequence_item(dest, node - src->nodes.start + 1, *item)) goto _error;
+          }
+        break;
+        case YAML_MAPPING_NODE:
+          for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair ++) {
+            if (!yaml_document_append_mapping_pair(dest, node - src->nodes.start + 1, pair->key, pair->value)) goto _error;
+          }
+        break;
+        default: break;
+      }
+    }
+    return 1;
+
+    _error:
+      YAML_LOG_e("Error while copying node, deleting document");
+      yaml_document_delete(dest);
+    return 0;
+  }
+
+
+
+  namespace libyaml_native {
+
+    /*\
+     * @brief YAML document to YAML/JSON string
+     *
+     * Serializes yaml_document to JSON minified, JSON pretty or YAML string.
+     *
+    \*/
+    size_t serializeYml( yaml_document_t* src_doc, String &dest_string, OutputFormat_t format )
+    {
+      StringStream dest_stream( dest_string );
+      return serializeYml( src_doc, dest_stream, format );
+    }
+
+
+    /*\
+     * @brief YAML document to YAML/JSONL stream
+     *
+     * Serializes yaml_document to JSON minified, JSON pretty or YAML stream.
+     *
+    \*/
+    size_t serializeYml( yaml_document_t* src_doc, Stream &dest_stream, OutputFormat_t format )
+    {
+      yaml_node_t* node;
+      if (node = yaml_document_get_root_node(src_doc), !node) { YAML_LOG_w("No document defined."); return 0; }
+      yaml_output_buffer_t out( &dest_stream );
+      yaml_serializer_context_t ctx = CreateSerializerContext( format );
+      yaml_traverser_t doc = { src_doc, node, &out, &ctx, YAMLNode::Type::Null, 0 };
+      size_t bytes_out = 0;
+      bytes_out = format==OutputFormat_t::OUTPUT_YAML? YAMLNode::toYAML( &doc ) : YAMLNode::toJSON( &doc );
+      out.flush();
+      return bytes_out;
+    }
+
+
+    /*\
+     * @brief YAML/JSON stream to YAML/JSON stream
+     *
+     * Output is transcoded from parser events as they come, so
+     * memory usage depends on nesting depth rather than document size.
+     * Only the first document of the stream is converted.
+     * Returns 0 on parse error or alias, dest_stream may then hold a
+     * truncated output if it exceeded YAML_OUTPUT_BUFFER_SIZE.
+     *
+    \*/
+    size_t serializeYml( Stream &src_stream, Stream &dest_stream, OutputFormat_t format )
+    {
+      size_t bytes_read = 0;
+      yaml_stream_handler_data_t shd = { &src_stream, &bytes_read };
+      yaml_parser_t parser;
+      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
+
+      if (yaml_parser_initialize(&parser) != 1) {
+        YAMLNode::handle_parser_error( &parser );
+        return 0;
+      }
+
+      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
+      yaml_parser_set_input(&parser, &_yaml_stream_reader, &shd);
+
+      yaml_output_buffer_t out( &dest_stream );
+      yaml_serializer_context_t ctx = CreateSerializerContext( format );
+      yaml_event_writer_t writer( &out, &ctx, format );
+      yaml_event_t event;
+      bool done = false;
+      bool failed = false;
+
+      while( !done ) {
+        if (yaml_parser_parse(&parser, &event) != 1) {
+          YAMLNode::handle_parser_error( &parser );
+          failed = true;
+          break;
+        }
+        done = ( event.type == YAML_DOCUMENT_END_EVENT || event.type == YAML_STREAM_END_EVENT );
+        if( !writer.write( &event ) ) done = failed = true;
+        yaml_event_delete(&event);
+      }
+
+      if( failed ) {
+        out.discard();
+        return 0;
+      }
+      out.flush();
+      return writer.bytes_out;
+    }
+
+
+    /*\
+     * @brief Growable bit stack
+     *
+     * The first 64 bits need no allocation.
+     *
+    \*/
+    struct yaml_bit_stack_t
+    {
+      uint64_t bits = 0;
+      std::vector<uint64_t> more; // bits 64 and up
+
+      bool get( size_t index ) const
+      {
+        if( index < 64 ) return (bits >> index) & 1;
+        index -= 64;
+        return (more[index/64] >> (index%64)) & 1;
+      }
+
+      void set( size_t index, bool value )
+      {
+        uint64_t *word = &bits;
+        if( index >= 64 ) {
+          index -= 64;
+          if( more.size() <= index/64 ) more.resize( index/64+1, 0 );
+          word = &more[index/64];
+        }
+        uint64_t mask = (uint64_t)1 << (index%64);
+        if( value ) *word |= mask;
+        else        *word &= ~mask;
+      }
+    };
+
+
+    /*\
+     * @brief Parser events to YAMLEventHandler
+     *
+     * Runs the parser over the whole stream (all documents) and tracks which
+     * nodes are mapping keys, two bits per nesting level with no depth limit.
+     * Returns false on parse error.
+     *
+    \*/
+    static bool yaml_parse_events( yaml_parser_t *parser, YAMLEventHandler &handler )
+    {
+      yaml_bit_stack_t levels; // is_map at 2*level, expects_key at 2*level+1
+      long top = -1;
+      yaml_event_t event;
+
+      // returns true if the node starting now is a mapping key
+      auto node_start = [&]() {
+        if( top < 0 || !levels.get( 2*top ) ) return false;
+        bool expects_key = !levels.get( 2*top+1 );
+        levels.set( 2*top+1, expects_key );
+        return !expects_key;
+      };
+
+      while( true ) {
+        if (yaml_parser_parse(parser, &event) != 1) {
+          YAMLNode::handle_parser_error( parser );
+          return false;
+        }
+        bool ok = true;
+        bool collection = false;
+        switch( event.type ) {
+          case YAML_STREAM_START_EVENT: break;
+          case YAML_STREAM_END_EVENT:
+            yaml_event_delete(&event);
+            return true;
+          case YAML_DOCUMENT_START_EVENT: ok = handler.onDocumentStart(); break;
+          case YAML_DOCUMENT_END_EVENT:   ok = handler.onDocumentEnd(); break;
+          case YAML_MAPPING_START_EVENT:
+            ok = handler.onMappingStart( (const char*)event.data.mapping_start.tag, (const char*)event.data.mapping_start.anchor, node_start() );
+            collection = true;
+          break;
+          case YAML_SEQUENCE_START_EVENT:
+            ok = handler.onSequenceStart( (const char*)event.data.sequence_start.tag, (const char*)event.data.sequence_start.anchor, node_start() );
+            collection = true;
+          break;
+          case YAML_MAPPING_END_EVENT:  top--; ok = handler.onMappingEnd(); break;
+          case YAML_SEQUENCE_END_EVENT: top--; ok = handler.onSequenceEnd(); break;
+          case YAML_SCALAR_EVENT:
+          {
+            bool is_key = node_start();
+            ok = handler.onScalar( (const char*)event.data.scalar.value, event.data.scalar.length, event.data.scalar.style,
+                                   (const char*)event.data.scalar.tag, (const char*)event.data.scalar.anchor, is_key );
+          }
+          break;
+          case YAML_ALIAS_EVENT: ok = handler.onAlias( (const char*)event.data.alias.anchor, node_start() ); break;
+          default: break;
+        }
+        if( collection ) {
+          top++;
+          levels.set( 2*top, event.type == YAML_MAPPING_START_EVENT );
+          levels.set( 2*top+1, true );
+        }
+        yaml_event_delete(&event);
+        if( !ok ) return true; // stopped by the handler
+      }
+    }
+
+
+    /*\
+     * @brief YAML stream to parser events
+     *
+     * SAX style: no document is built, the handler gets every event.
+     * Returns the read data size, or -1 on error.
+     *
+    \*/
+    int deserializeYml( YAMLEventHandler& handler, Stream &src_stream )
+    {
+      size_t bytes_read = 0;
+      yaml_stream_handler_data_t shd = { &src_stream, &bytes_read };
+      yaml_parser_t parser;
+      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
+
+      if (yaml_parser_initialize(&parser) != 1) {
+        YAMLNode::handle_parser_error( &parser );
+        return -1;
+      }
+
+      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
+      yaml_parser_set_input(&parser, &_yaml_stream_reader, &shd);
+
+      if( !yaml_parse_events( &parser, handler ) ) return -1;
+      return bytes_read;
+    }
+
+
+    /*\
+     * @brief YAML string to parser events
+     *
+     * SAX style: no document is built, the handler gets every event.
+     * Returns the read data size, or -1 on error.
+     *
+    \*/
+    int deserializeYml( YAMLEventHandler& handler, const char* src_yaml_str )
+    {
+      yaml_parser_t parser;
+      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
+
+      if (yaml_parser_initialize(&parser) != 1) {
+        YAMLNode::handle_parser_error( &parser );
+        return -1;
+      }
+
+      size_t len = strlen( src_yaml_str );
+      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
+      yaml_parser_set_input_string(&parser, (const unsigned char*)src_yaml_str, len);
+
+      if( !yaml_parse_events( &parser, handler ) ) return -1;
+      return len;
+    }
+
+
+    /*\
+     * @brief YAML string to YAMLNode
+     *
+     * Deserializes YAML or JSON string to YAMLNode.
+     * Returns the read data size.
+     *
+    \*/
+    int deserializeYml( YAMLNode& dest_obj, const char* src_yaml_str )
+    {
+      dest_obj = YAMLNode::loadString( src_yaml_str );
+      return strlen( src_yaml_str );
+    }
+
+
+    /*\
+     * @brief YAML stream to YAMLNode
+     *
+     * Deserializes YAML or JSON stream to YAMLNode.
+     * Returns the read data size.
+     *
+    \*/
+    int deserializeYml( YAMLNode& dest_obj, Stream &src_stream )
+    {
+      size_t bytes_read = 0;
+      yaml_stream_handler_data_t shd = { &src_stream, &bytes_read };
+      dest_obj = YAMLNode::loadStream( shd );
+      return bytes_read;
+    }
+
+  };
+
+
+
+  namespace YAMLNode_Class
+  {
+
+    #if defined __cpp_exceptions
+      #define YAMLNode_Fail( msg ) throw std::runtime_error(msg);
+    #else
+      #define YAMLNode_Fail( msg ) YAML_LOG_e(msg); return YAMLNode{};
+    #endif
+
+
+    /*\
+     * @brief Map lookup
+     *
+     * 'str' does not need to be zero-terminated, 'key_hash' is computed
+     * when needed if nullptr. Uses the key index on big mappings.
+     *
+    \*/
+    static yaml_node_t* yaml_node_map_find( yaml_document_t* document, yaml_key_index_t* keyindex, yaml_node_t* node, const char* str, size_t len, const uint32_t* key_hash )
+    {
+      const auto &mapping = node->data.mapping;
+
+      if( keyindex && yaml_key_index_covers( node ) && yaml_key_index_build( document, keyindex ) ) {
+        return yaml_key_index_find(document, keyindex, node, str, len, key_hash ? *key_hash : yaml_key_hash(str, len));
+      }
+
+      for (yaml_node_pair_t *iter = mapping.pairs.start; iter < mapping.pairs.top; ++iter) {
+        yaml_node_t *key = yaml_document_get_node(document, iter->key);
+        if (key == nullptr) continue;
+        if (key->type != YAML_SCALAR_NODE) continue;
+
+        const auto &scalar = key->data.scalar;
+        if (!utf8_equal(str, len, (const char*) scalar.value, scalar.length))  continue;
+
+        return yaml_document_get_node(document, iter->value);
+      }
+
+      return nullptr;
+    }
+
+
+    /*\
+     * @brief Path segment lookup
+     *
+     * Map key first, then sequence index unless 'keys_only' is set.
+     *
+    \*/
+    static yaml_node_t* yaml_node_path_step( yaml_document_t* document, yaml_key_index_t* keyindex, yaml_node_t* node, const char* str, size_t len, const uint32_t* key_hash, int index, bool keys_only )
+    {
+      if( node->type == YAML_MAPPING_NODE ) {
+        yaml_node_t *value = yaml_node_map_find( document, keyindex, node, str, len, key_hash );
+        if( value ) return value;
+      }
+      if( keys_only || index < 0 || node->type != YAML_SEQUENCE_NODE ) return nullptr;
+      const auto &sequence = node->data.sequence;
+      if( index >= sequence.items.top - sequence.items.start ) return nullptr;
+      return yaml_document_get_node(document, sequence.items.start[index]);
+    }
+
+
+    /*\
+     * @brief atoi() on a non zero-terminated path segment
+     *
+    \*/
+    static int yaml_path_segment_index( const char* str, size_t len )
+    {
+      size_t i = 0;
+      while( i<len && isspace((uint8_t)str[i]) ) i++;
+      bool negative = false;
+      if( i<len && ( str[i] == '-' || str[i] == '+' ) ) negative = ( str[i++] == '-' );
+      int value = 0;
+      while( i<len && str[i] >= '0' && str[i] <= '9' ) value = value*10 + ( str[i++] - '0' );
+      return negative ? -value : value;
+    }
+
+
+    /*\
+     * @brief Delimited path walker
+     *
+     * Calls step( str, len, index, keys_only ) for every segment, following
+     * the gettext() rules: empty segments are ignored, a path without delimiter
+     * is a single key lookup. Stops and returns false when step() fails.
+     *
+    \*/
+    template <typename Step>
+    static bool yaml_path_walk( const char* path, char delimiter, Step step )
+    {
+      if( strchr( path, delimiter ) == NULL ) { // no delimiter found, just a key
+        return step( path, strlen(path), -1, true );
+      }
+      const char* segment = path;
+      while( *segment ) { // walk through delimited properties
+        if( *segment == delimiter ) { segment++; continue; } // skip empty segments
+        const char* end = strchr( segment, delimiter );
+        size_t len = end ? end-segment : strlen( segment );
+        if( !step( segment, len, yaml_path_segment_index( segment, len ), false ) ) return false;
+        segment += len;
+      }
+      return true;
+    }
+
+
+    /*\
+     * @brief Compiled path resolver
+     *
+    \*/
+    static yaml_node_t* yaml_node_path_find( yaml_document_t* document, yaml_key_index_t* keyindex, yaml_node_t* node, const yaml_path_t &path )
+    {
+      if( node == nullptr ) return nullptr;
+      for( const auto &segment : path.segments ) {
+        node = yaml_node_path_step( document, keyindex, node, path.key(segment), segment.length, &segment.hash, segment.index, path.keys_only );
+        if( node == nullptr ) return nullptr;
+      }
+      return node;
+    }
+
+
+    /*\
+     * @brief Get the node type
+     *
+    \*/
+    YAMLNode::Type YAMLNode::type() const
+    {
+      if (mNode == nullptr) return Type::Null;
+
+      switch (mNode->type) {
+        case YAML_NO_NODE:
+          return Type::Null;
+        case YAML_SCALAR_NODE:
+          return Type::Scalar;
+        case YAML_SEQUENCE_NODE:
+          return Type::Sequence;
+        case YAML_MAPPING_NODE:
+          return Type::Map;
+      }
+      return Type::Null;
+    }
+
+
+    /*\
+     * @brief Get scalar value
+     *
+    \*/
+    const char* YAMLNode::scalar() const
+    {
+      if (type() != Type::Scalar) return nullptr;
+
+      const auto &scalar = mNode->data.scalar;
+      return (const char*)scalar.value;
+    }
+
+
+    /*\
+     * @brief Node Accessor (sequence)
+     *
+    \*/
+    YAMLNode YAMLNode::operator [] ( int i ) const
+    {
+      if (type() != Type::Sequence) return YAMLNode{};
+      if (i < 0) return YAMLNode{};
+
+      const auto &sequence = mNode->data.sequence;
+      yaml_node_item_t *item = sequence.items.start + i;
+      // is we out of range?
+      if (sequence.items.top <= item) return YAMLNode{};
+
+      yaml_node_t *node = yaml_document_get_node(mDocument.get(), *item);
+
+      return YAMLNode{mDocument, node, mKeyIndex};
+    }
+
+
+    /*\
+     * @brief Node Accessor (map)
+     *
+    \*/
+    YAMLNode YAMLNode::operator [] ( const char *str ) const
+    {
+      if (type() != Type::Map) return YAMLNode{};
+      yaml_node_t *value = yaml_node_map_find(mDocument.get(), mKeyIndex.get(), mNode, str, strlen(str), nullptr);
+      return value ? YAMLNode(mDocument, value, mKeyIndex) : YAMLNode{};
+    }
+
+
+    /*\
+     * @brief Node Accessor (compiled path)
+     *
+    \*/
+    YAMLNode YAMLNode::operator [] ( const yaml_path_t &path ) const
+    {
+      yaml_node_t *node = yaml_node_path_find( mDocument.get(), mKeyIndex.get(), mNode, path );
+      return node ? YAMLNode(mDocument, node, mKeyIndex) : YAMLNode{};
+    }
+
+
+    /*\
+     * @brief Node size
+     *
+    \*/
+    size_t YAMLNode::size() const
+    {
+      switch (type()) {
+        case Type::Null:
+        case Type::Scalar:
+          return 0;
+        case Type::Sequence:
+        {
+          const auto &sequence = mNode->data.sequence;
+          return sequence.items.top - sequence.items.start;
+        }
+        case Type::Map:
+        {
+          const auto &mapping = mNode->data.mapping;
+          return mapping.pairs.top - mapping.pairs.start;
+        }
+      }
+      return 0;
+    }
+
+
+    /*\
+     * @brief YAML String loader
+     *
+     * Note: this is a static method
+     *
+    \*/
+    YAMLNode YAMLNode::loadString( const char *str )
+    {
+      size_t len = strlen(str);
+      return loadString(str, len);
+    }
+
+
+    /*\
+     * @brief YAML String loader
+     *
+     * Note: this is a static method
+     *
+    \*/
+    YAMLNode YAMLNode::loadString( const char *str, size_t len )
+    {
+      yaml_arena_t *arena = CreateArena();
+      std::shared_ptr<yaml_document_t> document = CreateDocument( arena );
+      ArenaScope arenaScope( arena ); // parser and document allocations go to the arena, if any
+      yaml_parser_t parser;
+      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
+
+      if (yaml_parser_initialize(&parser) != 1) {
+        handle_parser_error( &parser );
+        YAMLNode_Fail("Failed to initialize yaml parser");
+      }
+      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
+      yaml_parser_set_input_string(&parser, (const unsigned char*)str, len);
+
+      if (yaml_parser_load(&parser, document.get()) != 1) {
+        handle_parser_error( &parser );
+        YAMLNode_Fail("Failed to load yaml document!");
+      }
+
+      yaml_node_t *root = yaml_document_get_root_node(document.get());
+      yaml_document_classify(document.get());
+      return YAMLNode(document, root, CreateKeyIndex(document.get()));
+    }
+
+
+    /*\
+     * @brief YAML in-situ String loader
+     *
+     * Note: this is a static method
+     *
+    \*/
+    YAMLNode YAMLNode::loadStringInSitu( char *str )
+    {
+      size_t len = strlen(str);
+      return loadStringInSitu(str, len);
+    }
+
+
+    /*\
+     * @brief YAML in-situ String loader
+     *
+     * Plain and simple single-quoted scalars are not copied, they point into 'str'
+     * which gets modified: str[len] must be writable and 'str' must outlive the document.
+     *
+     * Note: this is a static method
+     *
+    \*/
+    YAMLNode YAMLNode::loadStringInSitu( char *str, size_t len )
+    {
+      yaml_arena_t *arena = CreateArena( str, len );
+      std::shared_ptr<yaml_document_t> document = CreateDocument( arena );
+      ArenaScope arenaScope( arena ); // the arena is aware of in-situ scalars
+      yaml_parser_t parser;
+      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
+
+      if (yaml_parser_initialize(&parser) != 1) {
+        handle_parser_error( &parser );
+        YAMLNode_Fail("Failed to initialize yaml parser");
+      }
+      str[len] = '\0';
+      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
+      yaml_parser_set_input_string_insitu(&parser, (unsigned char*)str, len);
+
+      if (yaml_parser_load(&parser, document.get()) != 1) {
+        handle_parser_error( &parser );
+        YAMLNode_Fail("Failed to load yaml document!");
+      }
+
+      yaml_node_t *root = yaml_document_get_root_node(document.get());
+      yaml_document_classify(document.get());
+      return YAMLNode(document, root, CreateKeyIndex(document.get()));
+    }
+
+
+    /*\
+     * @brief YAML Stream loader (stream handler data)
+     *
+     * Note: this is a static method
+     *
+    \*/
+    YAMLNode YAMLNode::loadStream( yaml_stream_handler_data_t &shd )
+    {
+      yaml_arena_t *arena = CreateArena();
+      std::shared_ptr<yaml_document_t> document = CreateDocument( arena );
+      ArenaScope arenaScope( arena ); // parser and document allocations go to the arena, if any
+      yaml_parser_t parser;
+      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
+
+      if (yaml_parser_initialize(&parser) != 1) {
+        handle_parser_error( &parser );
+        YAMLNode_Fail("Failed to initialize yaml parser");
+      }
+
+      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
+      yaml_parser_set_input(&parser, &_yaml_stream_reader, &shd);
+
+      if (yaml_parser_load(&parser, document.get()) != 1) {
+        handle_parser_error( &parser );
+        YAMLNode_Fail("Failed to load yaml document!");
+      }
+
+      yaml_node_t *root = yaml_document_get_root_node(document.get());
+      yaml_document_classify(document.get());
+      return YAMLNode(document, root, CreateKeyIndex(document.get()));
+    }
+
+
+    /*\
+     * @brief YAML Stream loader (basic stream)
+     *
+     * Note: this is a static method
+     *
+    \*/
+    YAMLNode YAMLNode::loadStream( Stream &stream )
+    {
+      size_t bytes_read = 0;
+      yaml_stream_handler_data_t shd = { &stream, &bytes_read };
+      return loadStream( shd );
+    }
+
+
+    /*\
+     * @brief Path-filtered composer
+     *
+     * Replaces yaml_parser_load() for the first document of the stream, only nodes
+     * on the way to or inside the selected paths are composed. Every event is still
+     * parsed so syntax errors are reported. Skipped sequence items are replaced by
+     * a shared empty scalar so indexes are kept, skipped map pairs are dropped.
+     * Anchored nodes are always composed, detached when outside the selection,
+     * so aliases resolve to the real node. Undefined aliases fail like in
+     * yaml_parser_load().
+     *
+    \*/
+    struct yaml_filtered_composer_t
+    {
+      constexpr static const int max_paths = 32; // paths are tracked with a 32 bits mask
+
+      struct frame_t
+      {
+        int node;            // composed node id
+        bool is_map;
+        bool full;           // whole subtree is selected
+        uint32_t alive;      // paths matching this node so far
+        bool expects_key;    // maps: next node is a key
+        bool skip_value;     // maps: the current key is not selected
+        int key;             // maps: current key node id
+        bool child_full;     // maps: selection state of the current value
+        uint32_t child_alive;
+        int index;           // sequences: next item index
+        bool skipped;        // not composed, only anchored children are
+      };
+
+      yaml_parser_t *parser;
+      yaml_document_t *document;
+      std::vector<yaml_path_t> paths;
+      std::vector<frame_t> stack;
+      std::vector<std::pair<std::string, int>> anchors;
+      int null_node = 0;   // placeholder for skipped sequence items
+
+      yaml_filtered_composer_t( yaml_parser_t *_parser, yaml_document_t *doc, const char* const* _paths, size_t paths_count, char delimiter ) : parser(_parser), document(doc)
+      {
+        if( paths_count > max_paths ) {
+          YAML_LOG_w("Only the first %d paths are used", max_paths );
+          paths_count = max_paths;
+        }
+        for( size_t i=0; i<paths_count; i++ ) paths.emplace_back( _paths[i], delimiter );
+      }
+
+      // selection of a child node: paths whose next segment matches the key/index
+      void match( const frame_t &parent, const char* key, size_t len, int index, uint32_t *alive, bool *full )
+      {
+        size_t depth = stack.size()-1;
+        *alive = 0;
+        *full  = false;
+        for( size_t i=0; i<paths.size(); i++ ) {
+          if( !(parent.alive & (1u<<i)) ) continue;
+          const auto &segment = paths[i].segments[depth];
+          bool matched = key ? utf8_equal( key, len, paths[i].key(segment), segment.length )
+                             : ( !paths[i].keys_only && segment.index == index );
+          if( !matched ) continue;
+          if( depth+1 == paths[i].segments.size() ) *full = true;
+          else *alive |= (1u<<i);
+        }
+      }
+
+      // returns false when the node must be skipped, sets the selection of the node
+      bool select( const yaml_event_t *event, bool *full, uint32_t *alive )
+      {
+        if( stack.empty() ) { // root
+          *full = false;
+          *alive = 0;
+          for( size_t i=0; i<paths.size(); i++ ) {
+            if( paths[i].segments.empty() ) *full = true;
+            else *alive |= (1u<<i);
+          }
+          return true;
+        }
+        frame_t &parent = stack.back();
+        *full = parent.full;
+        *alive = 0;
+        if( parent.skipped ) return false;
+        if( parent.full ) {
+          if( parent.is_map ) parent.expects_key = !parent.expects_key;
+          return true;
+        }
+        if( parent.is_map ) {
+          if( parent.expects_key ) {
+            parent.expects_key = false;
+            parent.skip_value = true;
+            if( event->type != YAML_SCALAR_EVENT ) return false; // complex keys can't match a path
+            match( parent, (const char*)event->data.scalar.value, event->data.scalar.length, -1, &parent.child_alive, &parent.child_full );
+            parent.skip_value = !parent.child_full && !parent.child_alive;
+            return !parent.skip_value;
+          }
+          parent.expects_key = true;
+          *full  = parent.child_full;
+          *alive = parent.child_alive;
+          return !parent.skip_value;
+        }
+        match( parent, nullptr, 0, parent.index, alive, full );
+        if( *full || *alive ) return true;
+        // keep sequence indexes with a placeholder
+        if( !null_node ) null_node = yaml_document_add_scalar( document, nullptr, (const yaml_char_t*)"", 0, YAML_PLAIN_SCALAR_STYLE );
+        if( !null_node || !yaml_document_append_sequence_item( document, parent.node, null_node ) ) return false;
+        parent.index++;
+        return false;
+      }
+
+      // attach a composed node to its parent
+      bool attach( int node )
+      {
+        if( !node ) return false;
+        if( stack.empty() ) return true; // root
+        frame_t &parent = stack.back();
+        if( parent.is_map ) {
+          if( !parent.expects_key ) { // just selected a key
+            parent.key = node;
+            return true;
+          }
+          return yaml_document_append_mapping_pair( document, parent.node, parent.key, node );
+        }
+        parent.index++;
+        return yaml_document_append_sequence_item( document, parent.node, node );
+      }
+
+      void anchor( const yaml_char_t *name, int node )
+      {
+        if( name ) anchors.emplace_back( (const char*)name, node );
+      }
+
+      // finds the latest definition of an alias anchor, sets a composer error if there is none
+      bool resolve( const yaml_event_t *event, int *node )
+      {
+        for( auto it = anchors.rbegin(); it != anchors.rend(); ++it ) {
+          if( it->first == (const char*)event->data.alias.anchor ) {
+            *node = it->second;
+            return true;
+          }
+        }
+        parser->error = YAML_COMPOSER_ERROR;
+        parser->context = nullptr;
+        parser->problem = "found undefined alias";
+        parser->problem_mark = event->start_mark;
+        return false;
+      }
+
+      static const yaml_char_t* tag( const yaml_char_t *tag )
+      {
+        return ( tag && strcmp( (const char*)tag, "!" ) != 0 ) ? tag : nullptr; // non-specific tag: use the default
+      }
+
+      // returns false on memory error or undefined alias (parser->error is set)
+      bool compose( const yaml_event_t *event, bool *done )
+      {
+        int node;
+        bool full;
+        uint32_t alive;
+        switch( event->type ) {
+          case YAML_DOCUMENT_START_EVENT:
+          {
+            const auto &data = event->data.document_start;
+            return yaml_document_initialize( document, data.version_directive, data.tag_directives.start, data.tag_directives.end, data.implicit, 1 );
+          }
+          case YAML_DOCUMENT_END_EVENT:
+            document->end_implicit = event->data.document_end.implicit;
+            *done = true;
+          break;
+          case YAML_STREAM_END_EVENT: *done = true; break;
+          case YAML_SCALAR_EVENT:
+          {
+            const auto &data = event->data.scalar;
+            bool selected = select( event, &full, &alive );
+            if( !selected && !data.anchor ) return true;
+            node = yaml_document_add_scalar( document, tag(data.tag), data.value, data.length, data.style );
+            anchor( data.anchor, node );
+            return selected ? attach( node ) : node != 0; // skipped anchors are composed detached
+          }
+          case YAML_ALIAS_EVENT:
+          {
+            bool selected = select( event, &full, &alive );
+            if( !resolve( event, &node ) ) return false;
+            return selected ? attach( node ) : true;
+          }
+          case YAML_SEQUENCE_START_EVENT:
+          case YAML_MAPPING_START_EVENT:
+          {
+            bool is_map = ( event->type == YAML_MAPPING_START_EVENT );
+            const yaml_char_t *anchor_name = is_map ? event->data.mapping_start.anchor : event->data.sequence_start.anchor;
+            bool selected = select( event, &full, &alive );
+            if( !selected && !anchor_name ) { // not composed, anchored children still are
+              stack.push_back( { 0, is_map, false, 0, true, false, 0, false, 0, 0, true } );
+              return true;
+            }
+            node = is_map
+              ? yaml_document_add_mapping( document, tag(event->data.mapping_start.tag), event->data.mapping_start.style )
+              : yaml_document_add_sequence( document, tag(event->data.sequence_start.tag), event->data.sequence_start.style );
+            anchor( anchor_name, node );
+            if( selected ? !attach( node ) : !node ) return false;
+            stack.push_back( { node, is_map, full || !selected, alive, true, false, 0, false, 0, 0, false } ); // skipped anchors are composed whole, detached
+          }
+          break;
+          case YAML_SEQUENCE_END_EVENT:
+          case YAML_MAPPING_END_EVENT:
+            stack.pop_back();
+          break;
+          default: break;
+        }
+        return true;
+      }
+    };
+
+
+    /*\
+     * @brief Path-filtered loader
+     *
+     * Shared by the filtered loadString() and loadStream() variants.
+     *
+    \*/
+    static YAMLNode yaml_filtered_load( yaml_parser_t *parser, std::shared_ptr<yaml_document_t> document, const char* const* paths, size_t paths_count, char delimiter )
+    {
+      yaml_filtered_composer_t composer( parser, document.get(), paths, paths_count, delimiter );
+      yaml_event_t event;
+      bool done = false;
+      while( !done ) {
+        if (yaml_parser_parse(parser, &event) != 1) {
+          YAMLNode::handle_parser_error( parser );
+          YAMLNode_Fail("Failed to load yaml document!");
+        }
+        bool ok = composer.compose( &event, &done );
+        yaml_event_delete(&event);
+        if( !ok ) {
+          if( parser->error ) {
+            YAMLNode::handle_parser_error( parser );
+            YAMLNode_Fail("Failed to load yaml document!");
+          }
+          YAMLNode_Fail("Not enough memory for yaml document");
+        }
+      }
+      yaml_node_t *root = yaml_document_get_root_node(document.get());
+      yaml_document_classify(document.get());
+      return YAMLNode(document, root, CreateKeyIndex(document.get()));
+    }
+
+
+    /*\
+     * @brief YAML String loader, path-filtered
+     *
+     * Only composes the subtrees selected by 'paths' (gettext syntax).
+     *
+     * Note: this is a static method
+     *
+    \*/
+    YAMLNode YAMLNode::loadString( const char *str, const char* const* paths, size_t paths_count, char delimiter )
+    {
+      yaml_arena_t *arena = CreateArena();
+      std::shared_ptr<yaml_document_t> document = CreateDocument( arena );
+      ArenaScope arenaScope( arena ); // parser and document allocations go to the arena, if any
+      yaml_parser_t parser;
+      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
+
+      if (yaml_parser_initialize(&parser) != 1) {
+        handle_parser_error( &parser );
+        YAMLNode_Fail("Failed to initialize yaml parser");
+      }
+      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
+      yaml_parser_set_input_string(&parser, (const unsigned char*)str, strlen(str));
+      return yaml_filtered_load( &parser, document, paths, paths_count, delimiter );
+    }
+
+
+    /*\
+     * @brief YAML Stream loader, path-filtered
+     *
+     * Only composes the subtrees selected by 'paths' (gettext syntax).
+     *
+     * Note: this is a static method
+     *
+    \*/
+    YAMLNode YAMLNode::loadStream( Stream &stream, const char* const* paths, size_t paths_count, char delimiter )
+    {
+      size_t bytes_read = 0;
+      yaml_stream_handler_data_t shd = { &stream, &bytes_read };
+      yaml_arena_t *arena = CreateArena();
+      std::shared_ptr<yaml_document_t> document = CreateDocument( arena );
+      ArenaScope arenaScope( arena ); // parser and document allocations go to the arena, if any
+      yaml_parser_t parser;
+      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
+
+      if (yaml_parser_initialize(&parser) != 1) {
+        handle_parser_error( &parser );
+        YAMLNode_Fail("Failed to initialize yaml parser");
+      }
+      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
+      yaml_parser_set_input(&parser, &_yaml_stream_reader, &shd);
+      return yaml_filtered_load( &parser, document, paths, paths_count, delimiter );
+    }
+
+
+    /*\
+     * @brief Snapshot header check
+     *
+    \*/
+    static bool yaml_snapshot_header_valid( const yaml_snapshot_t::header_t* header )
+    {
+      return memcmp( header->magic, yaml_snapshot_t::magic_id, 4 ) == 0
+          && header->version == yaml_snapshot_t::version_id
+          && header->byte_order == yaml_snapshot_t::byte_order_id;
+    }
+
+
+    /*\
+     * @brief Snapshot image loader
+     *
+     * Validates the image and builds the document node table on top of it,
+     * items, pairs and strings are used in place. The document owns 'arena'.
+     *
+    \*/
+    static YAMLNode yaml_snapshot_load( const uint8_t* image, size_t size, yaml_arena_t* arena )
+    {
+      std::shared_ptr<yaml_document_t> document = CreateDocument( arena );
+      auto header = (const yaml_snapshot_t::header_t*)image;
+
+      if( !image || size < sizeof(yaml_snapshot_t::header_t) || ((uintptr_t)image & 3) ) {
+        YAMLNode_Fail("Invalid snapshot buffer (null, truncated or unaligned)");
+      }
+      if( !yaml_snapshot_header_valid( header ) ) {
+        YAMLNode_Fail("Unsupported snapshot format");
+      }
+      if( header->nodes > size/sizeof(yaml_snapshot_t::node_t) || header->items > size/sizeof(int32_t) || header->pairs > size/(2*sizeof(int32_t))
+       || yaml_snapshot_t::image_size( header ) != size ) {
+        YAMLNode_Fail("Snapshot size mismatch");
+      }
+
+      auto nodes = (const yaml_snapshot_t::node_t*)(header+1);
+      auto items = (const int32_t*)(nodes + header->nodes);
+      auto pairs = items + header->items;
+      auto pool  = (const char*)(pairs + 2*header->pairs);
+      uint32_t nodes_count = header->nodes;
+
+      if( header->pool_size == 0 || pool[header->pool_size-1] != '\0' ) { // every string must be terminated
+        YAMLNode_Fail("Corrupted snapshot string pool");
+      }
+      for( size_t i=0; i<header->items + 2*header->pairs; i++ ) {
+        if( items[i] < 1 || (uint32_t)items[i] > nodes_count ) {
+          YAMLNode_Fail("Corrupted snapshot node reference");
+        }
+      }
+
+      yaml_node_t *doc_nodes = (yaml_node_t*)arena->alloc( nodes_count*sizeof(yaml_node_t) );
+      yaml_node_item_t *doc_items = (yaml_node_item_t*)items;
+      yaml_node_pair_t *doc_pairs = (yaml_node_pair_t*)pairs;
+      if( sizeof(yaml_node_item_t) != sizeof(int32_t) || sizeof(yaml_node_pair_t) != 2*sizeof(int32_t) ) { // e.g. 16 bits int
+        doc_items = (yaml_node_item_t*)arena->alloc( header->items*sizeof(yaml_node_item_t) );
+        doc_pairs = (yaml_node_pair_t*)arena->alloc( header->pairs*sizeof(yaml_node_pair_t) );
+        if( doc_items && doc_pairs ) {
+          for( size_t i=0; i<header->items; i++ ) doc_items[i] = items[i];
+          for( size_t i=0; i<header->pairs; i++ ) doc_pairs[i] = { pairs[i*2], pairs[i*2+1] };
+        }
+      }
+      if( !doc_nodes || !doc_items || !doc_pairs ) {
+        YAMLNode_Fail("Not enough memory for snapshot nodes");
+      }
+      memset( doc_nodes, 0, nodes_count*sizeof(yaml_node_t) );
+
+      for( uint32_t i=0; i<nodes_count; i++ ) {
+        const auto &src = nodes[i];
+        yaml_node_t *node = &doc_nodes[i];
+        if( src.tag != yaml_snapshot_t::none && src.tag >= header->pool_size ) {
+          YAMLNode_Fail("Corrupted snapshot tag");
+        }
+        node->tag = src.tag == yaml_snapshot_t::none ? nullptr : (yaml_char_t*)pool + src.tag;
+        switch( src.type ) {
+          case YAML_SCALAR_NODE:
+            if( src.style > YAML_FOLDED_SCALAR_STYLE || (uint64_t)src.data + src.length >= header->pool_size || pool[src.data + src.length] != '\0' ) {
+              YAMLNode_Fail("Corrupted snapshot scalar");
+            }
+            node->data.scalar.value  = (yaml_char_t*)pool + src.data;
+            node->data.scalar.length = src.length;
+            node->data.scalar.style  = (yaml_scalar_style_t)src.style;
+          break;
+          case YAML_SEQUENCE_NODE:
+            if( src.style > YAML_FLOW_SEQUENCE_STYLE || (uint64_t)src.data + src.length > header->items ) {
+              YAMLNode_Fail("Corrupted snapshot sequence");
+            }
+            node->data.sequence.items.start = doc_items + src.data;
+            node->data.sequence.items.end   = node->data.sequence.items.top = doc_items + src.data + src.length;
+            node->data.sequence.style = (yaml_sequence_style_t)src.style;
+          break;
+          case YAML_MAPPING_NODE:
+            if( src.style > YAML_FLOW_MAPPING_STYLE || (uint64_t)src.data + src.length > header->pairs ) {
+              YAMLNode_Fail("Corrupted snapshot mapping");
+            }
+            node->data.mapping.pairs.start = doc_pairs + src.data;
+            node->data.mapping.pairs.end   = node->data.mapping.pairs.top = doc_pairs + src.data + src.length;
+            node->data.mapping.style = (yaml_mapping_style_t)src.style;
+          break;
+          default:
+            YAMLNode_Fail("Corrupted snapshot node type");
+        }
+        node->type = (yaml_node_type_t)src.type;
       }
-      return false;
+
+      document->nodes.start = doc_nodes;
+      document->nodes.end   = document->nodes.top = doc_nodes + nodes_count;
+      document->start_implicit = header->start_implicit;
+      document->end_implicit   = header->end_implicit;
+
+      yaml_node_t *root = yaml_document_get_root_node(document.get());
+      yaml_document_classify(document.get());
+      return YAMLNode(document, root, CreateKeyIndex(document.get()));
     }
 
 
     /*\
-     * @brief YAML multiline entities escaper for YAML output
+     * @brief Binary snapshot loader (memory)
      *
-     * Helper for serializers.
+     * Zero-copy: strings, items and pairs point into 'image' which must be
+     * 4 bytes aligned and outlive the document, only the node table is allocated.
+     *
+     * Note: this is a static method
      *
     \*/
-    void yaml_multiline_escape_string( Stream* stream, const char* str, size_t length, size_t *bytes_out, size_t depth )
+    YAMLNode YAMLNode::loadSnapshot( const uint8_t* image, size_t size )
     {
-      size_t i;
-      char c;
-      char l = '\0';
-      String _str = String(str);
-      char last_char = str[length-1];
-      bool has_multiline = _str.indexOf('\n') > -1;
-      bool has_ending_lf = last_char == '\n';
-      if( has_ending_lf ) { /*_str = _str.substring( 0, -1 );*/ length--; } // remove trailing lf
-      if( has_multiline ) *bytes_out += stream->printf("|%s\n%s", has_ending_lf?"":"-", indent(depth, YAML::YAML_INDENT) );
-
-      const char *str_ = _str.c_str(); // modified version of the string
-
-      for (i = 0; i < length; i++) {
-        c = *(str_ + i);
-        if( c== '\r' || c=='\n' ) {
-          if( l != '\\' && has_multiline ) { // unescaped \r or \n
-            if(c == '\r') *bytes_out += 1;  // ignore \r
-            else          *bytes_out += stream->printf("\n%s",  indent(depth, YAML::YAML_INDENT) ); // print CRLF
-          } else {
-            if(c == '\n') *bytes_out += stream->printf("\\n");
-            else          *bytes_out += stream->printf("\\r");
-          }
-        } else {
-          if( has_multiline ) {
-            *bytes_out += stream->printf("%c", c);
-          } else {
-            if      (c == '\\') *bytes_out += stream->printf("\\\\");
-            else if (c == '\0') *bytes_out += stream->printf("\\0");
-            else if (c == '\b') *bytes_out += stream->printf("\\b");
-            else if (c == '\t') *bytes_out += stream->printf("\\t");
-            else                *bytes_out += stream->printf("%c", c);
-          }
-        }
-        l = c; // memoize last char to spot escaped entities
-      }
+      return yaml_snapshot_load( image, size, CreateArena( (const char*)image, size ) );
     }
 
 
     /*\
-     * @brief YAML multiline entities escaper for YAML output
+     * @brief Binary snapshot loader (stream)
      *
-     * Helper for serializers.
+     * Reads the whole image in one block owned by the document.
+     *
+     * Note: this is a static method
      *
     \*/
-    void yaml_multiline_escape_string( Stream* stream, yaml_node_t *node, size_t *bytes_out, size_t depth )
+    YAMLNode YAMLNode::loadSnapshot( Stream &stream )
     {
-      // int plain_implicit = (strcmp((char *)node->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
-      bool quoted_implicit = (strcmp((char *)node->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
-      char quote = 0;
-      if( quoted_implicit ) {
-        switch( node->data.scalar.style )
-        {
-          case YAML_SINGLE_QUOTED_SCALAR_STYLE: quote = '\''; break;
-          case YAML_DOUBLE_QUOTED_SCALAR_STYLE: quote = '"'; break;
-          default: quoted_implicit = false; break;
-        }
+      yaml_snapshot_t::header_t header;
+      if( stream.readBytes( (char*)&header, sizeof(header) ) != sizeof(header) || !yaml_snapshot_header_valid( &header ) ) {
+        YAMLNode_Fail("Unsupported snapshot format");
+      }
+      size_t size = yaml_snapshot_t::image_size( &header );
+      yaml_arena_t *arena = CreateArena( nullptr, 0 ); // not in-situ, only used to own the image
+      uint8_t *image = (uint8_t*)arena->alloc( size );
+      if( !image ) {
+        delete arena;
+        YAMLNode_Fail("Not enough memory for snapshot");
       }
-      if( quoted_implicit ) *bytes_out+= stream->write(quote);
-      yaml_multiline_escape_string(stream, SCALAR_c(node), strlen(SCALAR_c(node)), bytes_out, depth );
-      if( quoted_implicit ) *bytes_out+= stream->write(quote);
+      memcpy( image, &header, sizeof(header) );
+      if( stream.readBytes( (char*)image + sizeof(header), size - sizeof(header) ) != size - sizeof(header) ) {
+        delete arena;
+        YAMLNode_Fail("Truncated snapshot");
+      }
+      if( yaml_stats_t* stats = yaml_get_stats() ) stats->bytes_in += size;
+      return yaml_snapshot_load( image, size, arena );
     }
 
 
-
-
     /*\
-     * @brief YAML string escaper for JSON output
+     * @brief Common tag lookup
      *
-     * Helper for serializers when escaping to JSON.
+     * Returns the pool offset of 'tag' when it is one of yaml_snapshot_t::tags(),
+     * yaml_snapshot_t::none otherwise.
      *
     \*/
-    void yaml_escape_quoted_string( Stream* stream, const char* str, size_t length, size_t *bytes_out )
+    static uint32_t yaml_snapshot_common_tag( const char* tag )
     {
-      size_t i;
-      char c;
-      for (i = 0; i < length; i++) {
-        c = *(str + i);
-        if      (c == '\\') *bytes_out += stream->printf("\\\\");
-        else if (c == '\0') *bytes_out += stream->printf("\\0");
-        else if (c == '\b') *bytes_out += stream->printf("\\b");
-        else if (c == '\n') *bytes_out += stream->printf("\\n");
-        else if (c == '\r') *bytes_out += stream->printf("\\r");
-        else if (c == '\t') *bytes_out += stream->printf("\\t");
-        else if (c == '"')  *bytes_out += stream->printf("\\\"");
-        else                *bytes_out += stream->printf("%c", c);
+      uint32_t offset = 0;
+      for( const char* const* common = yaml_snapshot_t::tags(); *common; common++ ) {
+        if( strcmp( tag, *common ) == 0 ) return offset;
+        offset += strlen( *common ) + 1;
       }
+      return yaml_snapshot_t::none;
     }
 
 
     /*\
-     * @brief Node content checker for JSON output.
+     * @brief Binary snapshot writer
      *
-     * Checks if scalar contents needs to be quoted
-     * when serializing to JSON.
+     * Writes 'document' as a relocatable image for loadSnapshot(), version
+     * and tag directives are not kept. Returns the image size, 0 on error.
+     *
+     * Note: this is a static method
      *
     \*/
-    bool scalar_needs_quote( yaml_node_t *node )
+    size_t YAMLNode::saveSnapshot( yaml_document_t* document, Stream &stream )
     {
-      if( node->type != YAML_SCALAR_NODE )
-        return false;
+      if( !document ) return 0;
+
+      // first pass: sizes
+      size_t tags_size = 0, pool_size = 0, items_count = 0, pairs_count = 0;
+      for( const char* const* common = yaml_snapshot_t::tags(); *common; common++ )
+        tags_size += strlen( *common ) + 1;
+      pool_size = tags_size;
+      for( yaml_node_t *node = document->nodes.start; node < document->nodes.top; node++ ) {
+        if( node->tag && yaml_snapshot_common_tag( (const char*)node->tag ) == yaml_snapshot_t::none )
+          pool_size += strlen( (const char*)node->tag ) + 1;
+        switch( node->type ) {
+          case YAML_SCALAR_NODE:   pool_size   += node->data.scalar.length + 1; break;
+          case YAML_SEQUENCE_NODE: items_count += node->data.sequence.items.top - node->data.sequence.items.start; break;
+          case YAML_MAPPING_NODE:  pairs_count += node->data.mapping.pairs.top - node->data.mapping.pairs.start; break;
+          default: break;
+        }
+      }
+      if( pool_size >= yaml_snapshot_t::none || items_count >= yaml_snapshot_t::none || pairs_count >= yaml_snapshot_t::none ) {
+        YAML_LOG_e("Document too big for snapshot");
+        return 0;
+      }
 
-      if( (strcmp((char *)node->tag, YAML_DEFAULT_SCALAR_TAG) == 0) ) {
-        switch( node->data.scalar.style )
-        {
-          case YAML_SINGLE_QUOTED_SCALAR_STYLE:
-          case YAML_DOUBLE_QUOTED_SCALAR_STYLE:
-            return true;
+      yaml_snapshot_t::header_t header;
+      memset( &header, 0, sizeof(header) );
+      memcpy( header.magic, yaml_snapshot_t::magic_id, 4 );
+      header.version        = yaml_snapshot_t::version_id;
+      header.byte_order     = yaml_snapshot_t::byte_order_id;
+      header.nodes          = document->nodes.top - document->nodes.start;
+      header.items          = items_count;
+      header.pairs          = pairs_count;
+      header.pool_size      = pool_size;
+      header.start_implicit = document->start_implicit ? 1 : 0;
+      header.end_implicit   = document->end_implicit ? 1 : 0;
+
+      yaml_output_buffer_t out( &stream );
+      out.write( (const char*)&header, sizeof(header) );
+
+      // second pass: node table, pool offsets follow the order of the last pass
+      uint32_t pool_offset = tags_size, items_offset = 0, pairs_offset = 0;
+      for( yaml_node_t *node = document->nodes.start; node < document->nodes.top; node++ ) {
+        yaml_snapshot_t::node_t rec = { (uint8_t)node->type, 0, 0, yaml_snapshot_t::none, 0, 0 };
+        if( node->tag ) {
+          rec.tag = yaml_snapshot_common_tag( (const char*)node->tag );
+          if( rec.tag == yaml_snapshot_t::none ) {
+            rec.tag = pool_offset;
+            pool_offset += strlen( (const char*)node->tag ) + 1;
+          }
+        }
+        switch( node->type ) {
+          case YAML_SCALAR_NODE:
+            rec.style  = node->data.scalar.style;
+            rec.data   = pool_offset;
+            rec.length = node->data.scalar.length;
+            pool_offset += node->data.scalar.length + 1;
+          break;
+          case YAML_SEQUENCE_NODE:
+            rec.style  = node->data.sequence.style;
+            rec.data   = items_offset;
+            rec.length = node->data.sequence.items.top - node->data.sequence.items.start;
+            items_offset += rec.length;
+          break;
+          case YAML_MAPPING_NODE:
+            rec.style  = node->data.mapping.style;
+            rec.data   = pairs_offset;
+            rec.length = node->data.mapping.pairs.top - node->data.mapping.pairs.start;
+            pairs_offset += rec.length;
           break;
           default: break;
         }
+        out.write( (const char*)&rec, sizeof(rec) );
       }
 
-      bool needs_quotes = true;
-      bool is_bool = false;
-      bool bool_value = false;
-      bool is_string = false;
-      bool is_hex = false;
-      __attribute__((unused)) double number;
-      char* scalar;
-      char* end;
-      scalar = SCALAR_s(node);
-      number = strtod(scalar, &end);
-      // NOTE: '0x...' hexadecimal representations pass the strtod() test, but we want to keep them as strings
-      is_hex = strlen(scalar)>2 && scalar[0]=='0' && (scalar[1]=='x' || scalar[1]=='X');
-      is_string = is_hex || (end == scalar || *end) ;
-      if( is_string && yaml_node_is_bool( node, &bool_value ) ) {
-        is_bool = true;
+      // items and pairs
+      for( yaml_node_t *node = document->nodes.start; node < document->nodes.top; node++ ) {
+        if( node->type != YAML_SEQUENCE_NODE ) continue;
+        for( yaml_node_item_t *item = node->data.sequence.items.start; item < node->data.sequence.items.top; item++ ) {
+          int32_t id = *item;
+          out.write( (const char*)&id, sizeof(id) );
+        }
+      }
+      for( yaml_node_t *node = document->nodes.start; node < document->nodes.top; node++ ) {
+        if( node->type != YAML_MAPPING_NODE ) continue;
+        for( yaml_node_pair_t *pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair++ ) {
+          int32_t ids[2] = { pair->key, pair->value };
+          out.write( (const char*)ids, sizeof(ids) );
+        }
       }
-      if(is_bool)        needs_quotes = false;
-      else if(is_string) needs_quotes = true;
-      else               needs_quotes = false; // number
-      return needs_quotes;
-    }
-
 
-  };
+      // string pool
+      for( const char* const* common = yaml_snapshot_t::tags(); *common; common++ )
+        out.write( *common, strlen( *common ) + 1 );
+      for( yaml_node_t *node = document->nodes.start; node < document->nodes.top; node++ ) {
+        if( node->tag && yaml_snapshot_common_tag( (const char*)node->tag ) == yaml_snapshot_t::none )
+          out.write( (const char*)node->tag, strlen( (const char*)node->tag ) + 1 );
+        if( node->type == YAML_SCALAR_NODE ) {
+          out.write( (const char*)node->data.scalar.value, node->data.scalar.length );
+          out.write( '\0' );
+        }
+      }
 
+      out.flush();
+      return yaml_snapshot_t::image_size( &header );
+    }
 
 
-  /*\
-   * @brief Set YAML indentation depth
-   *
-   * Minimum indentation is 2 spaces.
-   * Maximum is 16 spaces for retina screens :)
-  \*/
-  void setYAMLIndent( int spaces_per_indent )
-  {
-    if( spaces_per_indent < 2 ) spaces_per_indent = 2;
-    if( spaces_per_indent > MAX_INDENT_DEPTH ) spaces_per_indent = MAX_INDENT_DEPTH;
-    YAMLIndentDepth = spaces_per_indent;
-    YAML_INDENT_STRING = "";
-    for( int i=0;i<spaces_per_indent;i++ ) {
-      YAML_INDENT_STRING += String(YAML_SCALAR_SPACE);
+    /*\
+     * @brief Multi-document reader
+     *
+     * Documents use the default allocator: the parser outlives each of
+     * them so it can't allocate from a per-document arena.
+     *
+    \*/
+    void YAMLDocumentReader::init()
+    {
+      if (yaml_parser_initialize(&parser) != 1) {
+        YAMLNode::handle_parser_error( &parser );
+        done = failed = true;
+        return;
+      }
+      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
     }
-  }
 
 
-  /*\
-   * @brief Set JSON indentation depth
-   *
-   * Sanitize 'spaces_or_tabs' input var:
-   *  - must have spaces only or tabs only
-   *  - min/max requirements
-   *  - fallback values
-  \*/
-  void setJSONIndent( const char* spaces_or_tabs, int folding_depth )
-  {
-    bool is_valid_str = ( is_filled_with(' ', spaces_or_tabs ) || is_filled_with('\t', spaces_or_tabs ) );
-    if( !is_valid_str ) JSON_INDENT_STRING = JSON_SCALAR_TAB;
-    else                JSON_INDENT_STRING = String( spaces_or_tabs );
+    YAMLDocumentReader::YAMLDocumentReader( Stream &stream, InputFormat_t _format ) : format(_format)
+    {
+      init();
+      shd = new yaml_stream_handler_data_t{ &stream, &bytes_read };
+      if( !done && format == INPUT_YAML_STREAM ) yaml_parser_set_input(&parser, &_yaml_stream_reader, shd);
+    }
 
-    bool is_in_range  = strlen( spaces_or_tabs ) < MAX_INDENT_DEPTH;
-    if( !is_in_range ) JSONFoldindDepth = JSON_FOLDING_DEPTH;
-    else               JSONFoldindDepth = folding_depth;
-  }
 
+    YAMLDocumentReader::YAMLDocumentReader( const char* str, InputFormat_t _format ) : YAMLDocumentReader( str, strlen(str), _format ) { }
 
 
+    YAMLDocumentReader::YAMLDocumentReader( const char* str, size_t len, InputFormat_t _format ) : format(_format)
+    {
+      init();
+      if( done ) return;
+      if( format == INPUT_YAML_STREAM ) {
+        yaml_parser_set_input_string(&parser, (const unsigned char*)str, len);
+      } else {
+        input = str;
+        input_len = len;
+      }
+    }
 
 
-  /*\
-   * @brief YAML document copier
-   *
-   * Creates a copy of a given document.
-   *
-  \*/
-  int yaml_copy_document(yaml_document_t *dest, yaml_document_t *src)
-  {
-    yaml_node_t *node;
-    yaml_node_item_t *item;
-    yaml_node_pair_t *pair;
+    YAMLDocumentReader::~YAMLDocumentReader()
+    {
+      yaml_parser_delete(&parser);
+      delete shd;
+    }
 
-    if (!yaml_document_initialize(dest, src->version_directive, src->tag_directives.start, src->tag_directives.end, src->start_implicit, src->end_implicit)) return 0;
 
-    for (node = src->nodes.start; node < src->nodes.top; node ++) {
-      switch (node->type) {
-        case YAML_SCALAR_NODE:   if (!yaml_document_add_scalar(dest, node->tag, node->data.scalar.value, node->data.scalar.length, node->data.scalar.style)) goto _error; break;
-        case YAML_SEQUENCE_NODE: if (!yaml_document_add_sequence(dest, node->tag, node->data.sequence.style)) goto _error; break;
-        case YAML_MAPPING_NODE:  if (!yaml_document_add_mapping(dest, node->tag, node->data.mapping.style)) goto _error; break;
-        default: assert(0); break;
+    /*\
+     * @brief Load the next document
+     *
+     * The previous document held by 'node' is released first so memory
+     * stays bounded by one document (unless copies of 'node' are kept).
+     *
+    \*/
+    bool YAMLDocumentReader::next( YAMLNode &node )
+    {
+      node = YAMLNode{};
+      if( done ) return false;
+      if( format == INPUT_JSON_LINES ) return nextRecord( node );
+
+      std::shared_ptr<yaml_document_t> document = CreateDocument( nullptr );
+      if (yaml_parser_load(&parser, document.get()) != 1) {
+        YAMLNode::handle_parser_error( &parser );
+        done = failed = true;
+        return false;
       }
-    }
 
-    for (node = src->nodes.start; node < src->nodes.top; node ++) {
-      switch (node->type) {
-        case YAML_SEQUENCE_NODE:
-          for (item = node->data.sequence.items.start; item < node->data.sequence.items.top; item ++) {
-            if (!yaml_document_append_sequence_item(dest, node - src->nodes.start + 1, *item)) goto _error;
-          }
-        break;
-        case YAML_MAPPING_NODE:
-          for (pair = node->data.mapping.pairs.start; pair < node->data.mapping.pairs.top; pair ++) {
-            if (!yaml_document_append_mapping_pair(dest, node - src->nodes.start + 1, pair->key, pair->value)) goto _error;
-          }
-        break;
-        default: break;
+      yaml_node_t *root = yaml_document_get_root_node(document.get());
+      if( root == nullptr ) { // end of stream
+        done = true;
+        return false;
       }
+      docs_count++;
+      yaml_document_classify(document.get());
+      node = YAMLNode(document, root, CreateKeyIndex(document.get()));
+      return true;
     }
-    return 1;
-
-    _error:
-      YAML_LOG_e("Error while copying node, deleting document");
-      yaml_document_delete(dest);
-    return 0;
-  }
 
 
+    /*\
+     * @brief JSON-lines record splitter
+     *
+     * Returns the next line without its LF, false at end of input. Stream
+     * input is read by chunks, only the current record is kept in memory.
+     *
+    \*/
+    bool YAMLDocumentReader::nextLine( const char** line, size_t* len )
+    {
+      if( !shd ) { // string input
+        if( input_len == 0 ) return false;
+        const char* lf = (const char*)memchr( input, '\n', input_len );
+        *line = input;
+        *len  = lf ? lf-input : input_len;
+        size_t consumed = lf ? *len+1 : input_len;
+        input += consumed;
+        input_len -= consumed;
+        return true;
+      }
+      pending.erase( 0, pending_pos );
+      size_t scanned = 0, lf;
+      while( (lf = pending.find( '\n', scanned )) == std::string::npos ) {
+        uint8_t chunk[64];
+        size_t chunk_len = shd->streamPtr->readBytes( chunk, sizeof(chunk) );
+        if( chunk_len == 0 ) break; // end of stream
+        bytes_read += chunk_len;
+        scanned = pending.size();
+        pending.append( (const char*)chunk, chunk_len );
+      }
+      if( pending.empty() ) return false;
+      *line = pending.data();
+      *len  = lf == std::string::npos ? pending.size() : lf;
+      pending_pos = lf == std::string::npos ? pending.size() : lf+1;
+      return true;
+    }
 
-  namespace libyaml_native {
 
     /*\
-     * @brief YAML document to YAML/JSON string
+     * @brief Load the next JSON-lines record
      *
-     * Serializes yaml_document to JSON minified, JSON pretty or YAML string.
+     * Each non blank line is parsed as a whole document by a fresh
+     * parser, so a record never spills over the next line and records
+     * don't need '---' separators.
      *
     \*/
-    size_t serializeYml( yaml_document_t* src_doc, String &dest_string, OutputFormat_t format )
+    bool YAMLDocumentReader::nextRecord( YAMLNode &node )
     {
-      StringStream dest_stream( dest_string );
-      return serializeYml( src_doc, dest_stream, format );
+      const char* line;
+      size_t len;
+      while( nextLine( &line, &len ) ) {
+        yaml_parser_delete(&parser);
+        init();
+        if( done ) return false;
+        yaml_parser_set_input_string(&parser, (const unsigned char*)line, len);
+
+        std::shared_ptr<yaml_document_t> document = CreateDocument( nullptr );
+        if( yaml_parser_load(&parser, document.get()) == 1 && !yaml_document_get_root_node(document.get()) ) continue; // blank line
+        yaml_event_t event;
+        bool loaded = !parser.error && yaml_parser_parse(&parser, &event) == 1;
+        if( loaded ) {
+          if( event.type != YAML_STREAM_END_EVENT ) {
+            parser.error = YAML_PARSER_ERROR;
+            parser.problem = "expected a single value per line";
+            parser.problem_mark = event.start_mark;
+            loaded = false;
+          }
+          yaml_event_delete(&event);
+        }
+        if( !loaded ) {
+          YAMLNode::handle_parser_error( &parser );
+          YAML_LOG_e("Invalid JSON-lines record #%u", (unsigned)(docs_count+1) );
+          done = failed = true;
+          return false;
+        }
+
+        yaml_node_t *root = yaml_document_get_root_node(document.get());
+        docs_count++;
+        yaml_document_classify(document.get());
+        node = YAMLNode(document, root, CreateKeyIndex(document.get()));
+        return true;
+      }
+      done = true;
+      return false;
     }
 
 
     /*\
-     * @brief YAML document to YAML/JSONL stream
+     * @brief Snapshot node accessor (YAMLNodeView)
      *
-     * Serializes yaml_document to JSON minified, JSON pretty or YAML stream.
+     * Bounds are checked on access instead of validating the whole image
+     * upfront, returns nullptr for invalid ids or corrupted nodes.
      *
     \*/
-    size_t serializeYml( yaml_document_t* src_doc, Stream &dest_stream, OutputFormat_t format )
+    static const yaml_snapshot_t::node_t* yaml_snapshot_node( const uint8_t* image, uint32_t id )
     {
-      yaml_node_t* node;
-      if (node = yaml_document_get_root_node(src_doc), !node) { YAML_LOG_w("No document defined."); return 0; }
-      yaml_traverser_t doc = { src_doc, node, &dest_stream, YAMLNode::Type::Null, 0 };
-      size_t bytes_out = 0;
-      switch(format) {
-        case OutputFormat_t::OUTPUT_JSON: YAML::JSONFoldindDepth = -1; break;
-        case OutputFormat_t::OUTPUT_JSON_PRETTY: if( YAML::JSONFoldindDepth<0) YAML::JSONFoldindDepth = JSON_FOLDING_DEPTH; break;
-        default:
-        case OutputFormat_t::OUTPUT_YAML: break;
+      auto header = (const yaml_snapshot_t::header_t*)image;
+      if( !image || id == 0 || id > header->nodes ) return nullptr;
+      auto node = (const yaml_snapshot_t::node_t*)(header+1) + (id-1);
+      uint64_t end = (uint64_t)node->data + node->length;
+      switch( node->type ) {
+        case YAML_SCALAR_NODE:   return end < header->pool_size ? node : nullptr; // the pool is zero-terminated
+        case YAML_SEQUENCE_NODE: return end <= header->items ? node : nullptr;
+        case YAML_MAPPING_NODE:  return end <= header->pairs ? node : nullptr;
+        default: return nullptr;
       }
-      bytes_out = format==OutputFormat_t::OUTPUT_YAML? YAMLNode::toYAML( &doc ) : YAMLNode::toJSON( &doc );
-      return bytes_out;
+    }
+
+    static const int32_t* yaml_snapshot_items( const uint8_t* image )
+    {
+      auto header = (const yaml_snapshot_t::header_t*)image;
+      return (const int32_t*)((const yaml_snapshot_t::node_t*)(header+1) + header->nodes);
+    }
+
+    static const int32_t* yaml_snapshot_pairs( const uint8_t* image )
+    {
+      return yaml_snapshot_items( image ) + ((const yaml_snapshot_t::header_t*)image)->items;
+    }
+
+    static const char* yaml_snapshot_pool( const uint8_t* image )
+    {
+      return (const char*)( yaml_snapshot_pairs( image ) + 2*((const yaml_snapshot_t::header_t*)image)->pairs );
     }
 
 
     /*\
-     * @brief YAML string to YAMLNode
+     * @brief Snapshot path segment lookup (YAMLNodeView)
      *
-     * Deserializes YAML or JSON string to YAMLNode.
-     * Returns the read data size.
+     * Same rules as yaml_node_path_step(), map keys are scanned linearly.
+     * Returns the child node id, 0 when not found.
      *
     \*/
-    int deserializeYml( YAMLNode& dest_obj, const char* src_yaml_str )
+    static uint32_t yaml_snapshot_path_step( const uint8_t* image, uint32_t id, const char* str, size_t len, int index, bool keys_only )
     {
-      dest_obj = YAMLNode::loadString( src_yaml_str );
-      return strlen( src_yaml_str );
+      auto node = yaml_snapshot_node( image, id );
+      if( node == nullptr ) return 0;
+      if( node->type == YAML_MAPPING_NODE ) {
+        const int32_t* pairs = yaml_snapshot_pairs( image ) + 2*node->data;
+        const char* pool = yaml_snapshot_pool( image );
+        for( uint32_t i=0; i<node->length; i++ ) {
+          auto key = yaml_snapshot_node( image, pairs[i*2] );
+          if( key == nullptr || key->type != YAML_SCALAR_NODE ) continue;
+          if( utf8_equal( str, len, pool + key->data, key->length ) ) return pairs[i*2+1];
+        }
+      }
+      if( keys_only || index < 0 || node->type != YAML_SEQUENCE_NODE || (uint32_t)index >= node->length ) return 0;
+      return yaml_snapshot_items( image )[node->data + index];
     }
 
 
     /*\
-     * @brief YAML stream to YAMLNode
+     * @brief Snapshot view
      *
-     * Deserializes YAML or JSON stream to YAMLNode.
-     * Returns the read data size.
+     * Only the header is checked, nodes are checked when accessed.
+     * The view is null when the image is invalid.
      *
     \*/
-    int deserializeYml( YAMLNode& dest_obj, Stream &src_stream )
+    YAMLNodeView::YAMLNodeView( const uint8_t* image, size_t size )
     {
-      size_t bytes_read = 0;
-      yaml_stream_handler_data_t shd = { &src_stream, &bytes_read };
-      dest_obj = YAMLNode::loadStream( shd );
-      return bytes_read;
+      auto header = (const yaml_snapshot_t::header_t*)image;
+      if( !image || size < sizeof(yaml_snapshot_t::header_t) || ((uintptr_t)image & 3) ) {
+        YAML_LOG_e("Invalid snapshot buffer (null, truncated or unaligned)");
+        return;
+      }
+      if( !yaml_snapshot_header_valid( header ) ) {
+        YAML_LOG_e("Unsupported snapshot format");
+        return;
+      }
+      if( header->nodes > size/sizeof(yaml_snapshot_t::node_t) || header->items > size/sizeof(int32_t) || header->pairs > size/(2*sizeof(int32_t))
+       || yaml_snapshot_t::image_size( header ) > size ) { // size may be bigger, e.g. a flash partition
+        YAML_LOG_e("Snapshot size mismatch");
+        return;
+      }
+      if( header->pool_size == 0 || yaml_snapshot_pool( image )[header->pool_size-1] != '\0' ) {
+        YAML_LOG_e("Corrupted snapshot string pool");
+        return;
+      }
+      mImage = image;
+      mNode  = header->nodes > 0 ? 1 : 0;
     }
 
-  };
-
 
+    #if defined YAML_SNAPSHOT_MAP_FILE
+      /*\
+       * @brief Snapshot view over a memory-mapped file
+       *
+       * The mapping is released along with the last view using it.
+       *
+       * Note: this is a static method
+       *
+      \*/
+      YAMLNodeView YAMLNodeView::mapFile( const char* path )
+      {
+        int fd = ::open( path, O_RDONLY );
+        if( fd < 0 ) {
+          YAML_LOG_e("Failed to open %s", path );
+          return YAMLNodeView{};
+        }
+        struct stat st;
+        if( fstat( fd, &st ) != 0 || st.st_size <= 0 ) {
+          ::close( fd );
+          YAML_LOG_e("Failed to stat %s", path );
+          return YAMLNodeView{};
+        }
+        size_t size = st.st_size;
+        void* addr = mmap( nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        ::close( fd );
+        if( addr == MAP_FAILED ) {
+          YAML_LOG_e("Failed to map %s", path );
+          return YAMLNodeView{};
+        }
+        std::shared_ptr<const void> mapping( addr, [size]( const void* ptr ) { munmap( (void*)ptr, size ); } );
+        YAMLNodeView view( (const uint8_t*)addr, size );
+        if( view.mImage == nullptr ) return YAMLNodeView{};
+        return YAMLNodeView( mapping, view.mImage, view.mNode );
+      }
+    #endif
 
-  namespace YAMLNode_Class
-  {
 
-    #if defined __cpp_exceptions
-      #define YAMLNode_Fail( msg ) throw std::runtime_error(msg);
-    #else
-      #define YAMLNode_Fail( msg ) YAML_LOG_e(msg); return YAMLNode{};
+    #if defined YAML_SNAPSHOT_MAP_PARTITION
+      /*\
+       * @brief Snapshot view over a flash-mapped data partition
+       *
+       * The snapshot must be written at the start of the partition, only
+       * the image is mapped. The mapping is released along with the last view using it.
+       *
+       * Note: this is a static method
+       *
+      \*/
+      YAMLNodeView YAMLNodeView::mapPartition( const char* label )
+      {
+        const esp_partition_t* partition = esp_partition_find_first( ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label );
+        if( partition == nullptr ) {
+          YAML_LOG_e("Partition %s not found", label );
+          return YAMLNodeView{};
+        }
+        yaml_snapshot_t::header_t header;
+        if( esp_partition_read( partition, 0, &header, sizeof(header) ) != ESP_OK || !yaml_snapshot_header_valid( &header ) ) {
+          YAML_LOG_e("No snapshot in partition %s", label );
+          return YAMLNodeView{};
+        }
+        size_t size = yaml_snapshot_t::image_size( &header );
+        if( size > partition->size ) {
+          YAML_LOG_e("Snapshot size mismatch");
+          return YAMLNodeView{};
+        }
+        const void* addr = nullptr;
+        #if ESP_IDF_VERSION_MAJOR >= 5
+          esp_partition_mmap_handle_t handle;
+          esp_err_t err = esp_partition_mmap( partition, 0, size, ESP_PARTITION_MMAP_DATA, &addr, &handle );
+          auto unmap = [handle]( const void* ) { esp_partition_munmap( handle ); };
+        #else
+          spi_flash_mmap_handle_t handle;
+          esp_err_t err = esp_partition_mmap( partition, 0, size, SPI_FLASH_MMAP_DATA, &addr, &handle );
+          auto unmap = [handle]( const void* ) { spi_flash_munmap( handle ); };
+        #endif
+        if( err != ESP_OK ) {
+          YAML_LOG_e("Failed to map partition %s", label );
+          return YAMLNodeView{};
+        }
+        std::shared_ptr<const void> mapping( addr, unmap );
+        YAMLNodeView view( (const uint8_t*)addr, size );
+        if( view.mImage == nullptr ) return YAMLNodeView{};
+        return YAMLNodeView( mapping, view.mImage, view.mNode );
+      }
     #endif
 
 
     /*\
-     * @brief Get the node type
+     * @brief Get the view type
      *
     \*/
-    YAMLNode::Type YAMLNode::type() const
+    YAMLNodeView::Type YAMLNodeView::type() const
     {
-      if (mNode == nullptr) return Type::Null;
-
-      switch (mNode->type) {
-        case YAML_NO_NODE:
-          return Type::Null;
-        case YAML_SCALAR_NODE:
-          return Type::Scalar;
-        case YAML_SEQUENCE_NODE:
-          return Type::Sequence;
-        case YAML_MAPPING_NODE:
-          return Type::Map;
+      auto node = yaml_snapshot_node( mImage, mNode );
+      if( node == nullptr ) return Type::Null;
+      switch( node->type ) {
+        case YAML_SCALAR_NODE:   return Type::Scalar;
+        case YAML_SEQUENCE_NODE: return Type::Sequence;
+        case YAML_MAPPING_NODE:  return Type::Map;
+        default: return Type::Null;
       }
-      return Type::Null;
     }
 
 
@@ -619,170 +3325,95 @@ namespace YAML
      * @brief Get scalar value
      *
     \*/
-    const char* YAMLNode::scalar() const
-    {
-      if (type() != Type::Scalar) return nullptr;
-
-      const auto &scalar = mNode->data.scalar;
-      return (const char*)scalar.value;
-    }
-
-
-    /*\
-     * @brief Node Accessor (sequence)
-     *
-    \*/
-    YAMLNode YAMLNode::operator [] ( int i ) const
+    const char* YAMLNodeView::scalar() const
     {
-      if (type() != Type::Sequence) return YAMLNode{};
-      if (i < 0) return YAMLNode{};
-
-      const auto &sequence = mNode->data.sequence;
-      yaml_node_item_t *item = sequence.items.start + i;
-      // is we out of range?
-      if (sequence.items.top <= item) return YAMLNode{};
-
-      yaml_node_t *node = yaml_document_get_node(mDocument.get(), *item);
-
-      return YAMLNode{mDocument, node};
+      auto node = yaml_snapshot_node( mImage, mNode );
+      if( node == nullptr || node->type != YAML_SCALAR_NODE ) return nullptr;
+      return yaml_snapshot_pool( mImage ) + node->data;
     }
 
 
     /*\
-     * @brief Node Accessor (map)
+     * @brief View size
      *
     \*/
-    YAMLNode YAMLNode::operator [] ( const char *str ) const
+    size_t YAMLNodeView::size() const
     {
-      if (type() != Type::Map) return YAMLNode{};
-
-      size_t len = strlen(str);
-
-      const auto &mapping = mNode->data.mapping;
-      for (yaml_node_pair_t *iter = mapping.pairs.start; iter < mapping.pairs.top; ++iter) {
-        yaml_node_t *key = yaml_document_get_node(mDocument.get(), iter->key);
-        if (key == nullptr) continue;
-        if (key->type != YAML_SCALAR_NODE) continue;
-
-        const auto &scalar = key->data.scalar;
-        if (!utf8_equal(str, len, (const char*) scalar.value, scalar.length))  continue;
-
-        yaml_node_t *value = yaml_document_get_node(mDocument.get(), iter->value);
-        return YAMLNode(mDocument, value);
-      }
-
-      return YAMLNode{};
+      auto node = yaml_snapshot_node( mImage, mNode );
+      if( node == nullptr || node->type == YAML_SCALAR_NODE ) return 0;
+      return node->length;
     }
 
 
     /*\
-     * @brief Node size
+     * @brief View Accessor (sequence)
      *
     \*/
-    size_t YAMLNode::size() const
+    YAMLNodeView YAMLNodeView::operator [] ( int i ) const
     {
-      switch (type()) {
-        case Type::Null:
-        case Type::Scalar:
-          return 0;
-        case Type::Sequence:
-        {
-          const auto &sequence = mNode->data.sequence;
-          return sequence.items.top - sequence.items.start;
-        }
-        case Type::Map:
-        {
-          const auto &mapping = mNode->data.mapping;
-          return mapping.pairs.top - mapping.pairs.start;
-        }
-      }
-      return 0;
+      if( type() != Type::Sequence ) return YAMLNodeView{};
+      uint32_t id = yaml_snapshot_path_step( mImage, mNode, "", 0, i, false );
+      return id ? YAMLNodeView( mMapping, mImage, id ) : YAMLNodeView{};
     }
 
 
     /*\
-     * @brief YAML String loader
-     *
-     * Note: this is a static method
+     * @brief View Accessor (map)
      *
     \*/
-    YAMLNode YAMLNode::loadString( const char *str )
+    YAMLNodeView YAMLNodeView::operator [] ( const char *str ) const
     {
-      size_t len = strlen(str);
-      return loadString(str, len);
+      if( type() != Type::Map ) return YAMLNodeView{};
+      uint32_t id = yaml_snapshot_path_step( mImage, mNode, str, strlen(str), -1, true );
+      return id ? YAMLNodeView( mMapping, mImage, id ) : YAMLNodeView{};
     }
 
 
     /*\
-     * @brief YAML String loader
-     *
-     * Note: this is a static method
+     * @brief View Accessor (compiled path)
      *
     \*/
-    YAMLNode YAMLNode::loadString( const char *str, size_t len )
+    YAMLNodeView YAMLNodeView::operator [] ( const yaml_path_t &path ) const
     {
-      yaml_parser_t parser;
-      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
-
-      if (yaml_parser_initialize(&parser) != 1) {
-        handle_parser_error( &parser );
-        YAMLNode_Fail("Failed to initialize yaml parser");
-      }
-      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
-      yaml_parser_set_input_string(&parser, (const unsigned char*)str, len);
-
-      std::shared_ptr<yaml_document_t> document = CreateDocument();
-      if (yaml_parser_load(&parser, document.get()) != 1) {
-        handle_parser_error( &parser );
-        YAMLNode_Fail("Failed to load yaml document!");
+      uint32_t id = mImage ? mNode : 0;
+      for( const auto &segment : path.segments ) {
+        id = yaml_snapshot_path_step( mImage, id, path.key(segment), segment.length, segment.index, path.keys_only );
+        if( id == 0 ) return YAMLNodeView{};
       }
-
-      yaml_node_t *root = yaml_document_get_root_node(document.get());
-      return YAMLNode(document, root);
+      return YAMLNodeView( mMapping, mImage, id );
     }
 
 
     /*\
-     * @brief YAML Stream loader (stream handler data)
+     * @brief l10n style gettext
      *
-     * Note: this is a static method
+     * Same as YAMLNode::gettext(), walks the snapshot image.
      *
     \*/
-    YAMLNode YAMLNode::loadStream( yaml_stream_handler_data_t &shd )
+    const char* YAMLNodeView::gettext( const char* path, char delimiter ) const
     {
-      yaml_parser_t parser;
-      std::unique_ptr<yaml_parser_t, ParserDelete> parserDelete(&parser);
-
-      if (yaml_parser_initialize(&parser) != 1) {
-        handle_parser_error( &parser );
-        YAMLNode_Fail("Failed to initialize yaml parser");
-      }
-
-      yaml_parser_set_encoding(&parser, YAML_UTF8_ENCODING);
-      yaml_parser_set_input(&parser, &_yaml_stream_reader, &shd);
-
-      std::shared_ptr<yaml_document_t> document = CreateDocument();
-      if (yaml_parser_load(&parser, document.get()) != 1) {
-        handle_parser_error( &parser );
-        YAMLNode_Fail("Failed to load yaml document!");
-      }
-
-      yaml_node_t *root = yaml_document_get_root_node(document.get());
-      return YAMLNode(document, root);
+      if( !path ) return "";
+      if( this->isNull() ) return path;
+      uint32_t id = mNode;
+      bool found = yaml_path_walk( path, delimiter, [&]( const char* str, size_t len, int index, bool keys_only ) {
+        id = yaml_snapshot_path_step( mImage, id, str, len, index, keys_only );
+        return id != 0;
+      });
+      if( !found || yaml_snapshot_node( mImage, id ) == nullptr ) return path;
+      return YAMLNodeView( nullptr, mImage, id ).scalar();
     }
 
 
     /*\
-     * @brief YAML Stream loader (basic stream)
-     *
-     * Note: this is a static method
+     * @brief l10n style gettext (compiled path)
      *
     \*/
-    YAMLNode YAMLNode::loadStream( Stream &stream )
+    const char* YAMLNodeView::gettext( const yaml_path_t &path ) const
     {
-      size_t bytes_read = 0;
-      yaml_stream_handler_data_t shd = { &stream, &bytes_read };
-      return loadStream( shd );
+      if( this->isNull() ) return path.c_str();
+      YAMLNodeView view = (*this)[path];
+      if( view.isNull() ) return path.c_str();
+      return view.scalar();
     }
 
 
@@ -790,55 +3421,38 @@ namespace YAML
      * @brief l10n style gettext
      *
      * L10N: Return localized string when given a path e.g. 'blah:some:property:count:1'
+     * Does not allocate nor modify the node, see yaml_path_t for repeated lookups.
      *
     \*/
-    const char* YAMLNode::gettext( const char* path, char delimiter)
+    const char* YAMLNode::gettext( const char* path, char delimiter ) const
     {
       if( !path ) return "";
-      const char delimStr[2] = { delimiter, 0 };
-      char* pathCopy = strdup( path );
-      char *found = NULL;
-      yaml_node_t* root_node = mNode;
-      void* retPtr = (void*)path;
-
-      if( this->isNull()) goto _not_found; // uh-oh, language not loaded
+      if( this->isNull() ) return path; // uh-oh, language not loaded
 
-      if( strchr( path, delimiter ) == NULL ) { // no delimiter found, just a key
-        YAMLNode tmp = (*this)[path];
-        if( tmp.isNull() ) goto _not_found; // no property under this name
-        this->mNode = tmp.mNode;
-        goto _success;
-      }
+      yaml_document_t* document = mDocument.get();
+      yaml_key_index_t* keyindex = mKeyIndex.get();
+      yaml_node_t* node = mNode;
 
-      found = strtok( pathCopy, delimStr ); // walk through delimited properties
-
-      while( found != NULL ) {
-        YAMLNode tmpMap = (*this)[found];
-        if( !tmpMap.isNull() ) { // map key->val
-          this->mNode = tmpMap.mNode;
-        } else {
-          int idx = atoi( found );
-          YAMLNode tmpSeq = (*this)[idx];
-          if( idx >= 0 && !tmpSeq.isNull() ) { // array index->val
-            this->mNode = tmpSeq.mNode;
-          } else {
-            goto _not_found; // delimited string/index not in yaml tree
-          }
-        }
-        found = strtok( NULL, delimStr ); // get next token
-      }
+      bool found = yaml_path_walk( path, delimiter, [&]( const char* str, size_t len, int index, bool keys_only ) {
+        node = yaml_node_path_step( document, keyindex, node, str, len, nullptr, index, keys_only );
+        return node != nullptr;
+      });
+      if( !found ) return path; // delimited string/index not in yaml tree
 
-      if( this->isNull() ) goto _not_found; // no match
+      return node->type == YAML_SCALAR_NODE ? (const char*)node->data.scalar.value : nullptr;
+    }
 
-      _success:
-        free( pathCopy );
-        retPtr = (void*)this->scalar();
-        this->mNode = root_node;
-        return (const char*)retPtr;
 
-      _not_found:
-        free( pathCopy );
-        return path; // not found
+    /*\
+     * @brief l10n style gettext (compiled path)
+     *
+    \*/
+    const char* YAMLNode::gettext( const yaml_path_t &path ) const
+    {
+      if( this->isNull() ) return path.c_str(); // uh-oh, language not loaded
+      yaml_node_t* node = yaml_node_path_find( mDocument.get(), mKeyIndex.get(), mNode, path );
+      if( node == nullptr ) return path.c_str(); // not found
+      return node->type == YAML_SCALAR_NODE ? (const char*)node->data.scalar.value : nullptr;
     }
 
 
@@ -868,6 +3482,12 @@ namespace YAML
           else
             YAML_LOG_e("[P]: %s at line %d, column %d", p->problem, p->problem_mark.line+1, p->problem_mark.column+1 );
         break;
+        case YAML_COMPOSER_ERROR:
+          if (p->context)
+            YAML_LOG_e("[C]: %s at line %d, column %d\n" "%s at line %d, column %d", p->context, p->context_mark.line+1, p->context_mark.column+1, p->problem, p->problem_mark.line+1, p->problem_mark.column+1 );
+          else
+            YAML_LOG_e("[C]: %s at line %d, column %d", p->problem, p->problem_mark.line+1, p->problem_mark.column+1 );
+        break;
         default: /* Couldn't happen. */ YAML_LOG_e( "[INTERNAL ERROR]"); break;
       }
     }
@@ -899,11 +3519,12 @@ namespace YAML
       assert( it );
       assert( it->node );
       assert( it->document );
-      assert( it->stream );
+      assert( it->out );
       // just some aliasing
       auto      node = it->node;
       auto  document = it->document;
-      auto    stream = it->stream;
+      auto       out = it->out;
+      auto       ctx = it->ctx;
       auto     depth = it->depth;
       auto nest_type = it->type;
 
@@ -917,30 +3538,33 @@ namespace YAML
       switch (node->type) {
         case YAML_SCALAR_NODE:
           needs_quotes = scalar_needs_quote( node );
-          if( needs_quotes ) bytes_out += stream->printf("\"");
-          yaml_escape_quoted_string( stream, SCALAR_c(node), strlen(SCALAR_c(node)), &bytes_out );
-          if( needs_quotes ) bytes_out += stream->printf("\"");
+          if( needs_quotes ) bytes_out += out->write('"');
+          yaml_escape_quoted_string( out, SCALAR_c(node), strlen(SCALAR_c(node)), &bytes_out );
+          if( needs_quotes ) bytes_out += out->write('"');
         break;
         case YAML_SEQUENCE_NODE:
-          bytes_out += stream->printf("[");
+          bytes_out += out->write('[');
           node_max = node->data.sequence.items.top - node->data.sequence.items.start;
           for (auto item_i = node->data.sequence.items.start; item_i < node->data.sequence.items.top; ++item_i) {
             auto node_item = yaml_document_get_node(document, *item_i);
             int child_level = node_item->type == YAML_MAPPING_NODE ? depth+1 : depth-1;
-            yaml_traverser_t seq_item = { document, yaml_document_get_node(document, *item_i), stream, YAMLNode::Type::Sequence, child_level };
+            yaml_traverser_t seq_item = { document, yaml_document_get_node(document, *item_i), out, ctx, YAMLNode::Type::Sequence, child_level };
             bytes_out += toJSON( &seq_item );
             node_count++;
             if( node_count < node_max ) {
-              bytes_out += stream->printf(", ");
+              bytes_out += out->write(", ", 2);
             }
           }
-          bytes_out += stream->printf("]");
+          bytes_out += out->write(']');
         break;
         case YAML_MAPPING_NODE:
           is_seq = ( depth>0 && nest_type == YAMLNode::Type::Sequence );
-          needs_folding = (depth>YAML::JSONFoldindDepth);
-          bytes_out += stream->printf("{");
-          if( !needs_folding ) bytes_out += stream->printf("\n%s", indent(depth+1, YAML::JSON_INDENT) );
+          needs_folding = (depth>ctx->folding_depth);
+          bytes_out += out->write('{');
+          if( !needs_folding ) {
+            bytes_out += out->write('\n');
+            bytes_out += ctx->indent( out, depth+1, OUTPUT_JSON );
+          }
           node_max = node->data.mapping.pairs.top - node->data.mapping.pairs.start;
           for (auto pair_i = node->data.mapping.pairs.start; pair_i < node->data.mapping.pairs.top; ++pair_i) {
             auto key   = yaml_document_get_node(document, pair_i->key);
@@ -949,17 +3573,26 @@ namespace YAML
               YAML_LOG_e("Mapping key is not scalar (line %lu).", key->start_mark.line);
               continue;
             }
-            yaml_traverser_t map_item = { document, value, stream, YAMLNode::Type::Map, depth+1 };
-            bytes_out += stream->printf("\"%s\": ", SCALAR_c(key) );
+            yaml_traverser_t map_item = { document, value, out, ctx, YAMLNode::Type::Map, depth+1 };
+            bytes_out += out->write('"');
+            bytes_out += out->write( SCALAR_c(key), key->data.scalar.length );
+            bytes_out += out->write("\": ", 3);
             bytes_out += toJSON( &map_item );
             node_count++;
             if( node_count < node_max ) {
-              if( !needs_folding ) bytes_out += stream->printf(",\n%s", indent(depth+1, YAML::JSON_INDENT) );
-              else bytes_out += stream->printf(", ");
+              if( !needs_folding ) {
+                bytes_out += out->write(",\n", 2);
+                bytes_out += ctx->indent( out, depth+1, OUTPUT_JSON );
+              } else {
+                bytes_out += out->write(", ", 2);
+              }
             }
           }
-          if( !needs_folding ) bytes_out += stream->printf("\n%s", indent( is_seq ? depth-1 : depth, YAML::JSON_INDENT) );
-          bytes_out += stream->printf("}");
+          if( !needs_folding ) {
+            bytes_out += out->write('\n');
+            bytes_out += ctx->indent( out, is_seq ? depth-1 : depth, OUTPUT_JSON );
+          }
+          bytes_out += out->write('}');
         break;
         case YAML_NO_NODE: break;
         default: YAML_LOG_e("Unknown node type (line %lu).", node->start_mark.line); break;
@@ -979,11 +3612,12 @@ namespace YAML
       assert( it );
       assert( it->node );
       assert( it->document );
-      assert( it->stream );
+      assert( it->out );
       // just some aliasing
       auto      node = it->node;
       auto  document = it->document;
-      auto    stream = it->stream;
+      auto       out = it->out;
+      auto       ctx = it->ctx;
       auto     depth = it->depth;
       auto nest_type = it->type;
 
@@ -992,14 +3626,18 @@ namespace YAML
 
       switch (node->type) {
         case YAML_SCALAR_NODE:
-          if ( nest_type == YAMLNode::Type::Sequence ) bytes_out += stream->printf("\n%s%s",  indent(depth, YAML::YAML_INDENT), index() );
-          yaml_multiline_escape_string( stream, node, &bytes_out, depth );
+          if ( nest_type == YAMLNode::Type::Sequence ) {
+            bytes_out += out->write('\n');
+            bytes_out += ctx->indent( out, depth, OUTPUT_YAML );
+            bytes_out += ctx->index( out );
+          }
+          yaml_multiline_escape_string( out, node, &bytes_out, depth, ctx );
         break;
         case YAML_SEQUENCE_NODE:
           for (auto item_i = node->data.sequence.items.start; item_i < node->data.sequence.items.top; ++item_i) {
             auto node_item = yaml_document_get_node(document, *item_i);
             int child_level = node_item->type == YAML_MAPPING_NODE ? depth+1 : depth-1;
-            yaml_traverser_t seq_item = { document, yaml_document_get_node(document, *item_i), stream, YAMLNode::Type::Sequence, child_level };
+            yaml_traverser_t seq_item = { document, yaml_document_get_node(document, *item_i), out, ctx, YAMLNode::Type::Sequence, child_level };
             bytes_out += toYAML( &seq_item );
           }
         break;
@@ -1012,8 +3650,12 @@ namespace YAML
               YAML_LOG_e("Mapping key is not scalar (line %lu).", key->start_mark.line);
               continue;
             }
-            yaml_traverser_t map_item = { document, value, stream, YAMLNode::Type::Map, depth+1 };
-            bytes_out += stream->printf("\n%s%s%s: ", is_seqfirst ? indent(parent_level, YAML::YAML_INDENT) : indent(depth, YAML::YAML_INDENT), is_seqfirst ? index() : "", SCALAR_c(key) );
+            yaml_traverser_t map_item = { document, value, out, ctx, YAMLNode::Type::Map, depth+1 };
+            bytes_out += out->write('\n');
+            bytes_out += ctx->indent( out, is_seqfirst ? parent_level : depth, OUTPUT_YAML );
+            if( is_seqfirst ) bytes_out += ctx->index( out );
+            bytes_out += out->write( SCALAR_c(key), key->data.scalar.length );
+            bytes_out += out->write(": ", 2);
             bytes_out += toYAML( &map_item );
           }
         break;
@@ -1031,120 +3673,286 @@ namespace YAML
 
     namespace libyaml_arduinojson
     {
+      /*\
+       * @brief Scalar to JsonVariant
+       *
+       * Quoted scalars are strings, plain truthy/falsy values are booleans,
+       * integers within int64_t range are stored as such, other numbers as double.
+       *
+      \*/
+      static void yaml_scalar_to_json( JsonVariant dst, const char* scalar, yaml_scalar_style_t style, yaml_scalar_class_t scalar_class )
+      {
+        if( style == YAML_SINGLE_QUOTED_SCALAR_STYLE || style == YAML_DOUBLE_QUOTED_SCALAR_STYLE ) {
+          scalar_class = YAML_SCALAR_CLASS_STRING;
+        }
+        switch( scalar_class ) {
+          case YAML_SCALAR_CLASS_TRUE:  dst.set( true ); break;
+          case YAML_SCALAR_CLASS_FALSE: dst.set( false ); break;
+          case YAML_SCALAR_CLASS_INT:
+          {
+            char* end;
+            errno = 0;
+            long long number = strtoll( scalar, &end, 10 );
+            if( errno != ERANGE && *end == '\0' ) {
+              dst.set( (int64_t)number );
+              break;
+            }
+          }
+          // out of range or signed hex (e.g. '-0x10'), parsed as double
+          // fall through
+          case YAML_SCALAR_CLASS_HEX:
+          {
+            double number = strtod( scalar, NULL );
+            if( number > -9.2e18 && number < 9.2e18 ) dst.set( (int64_t)number );
+            else                                      dst.set( number );
+          }
+          break;
+          case YAML_SCALAR_CLASS_FLOAT: dst.set( strtod( scalar, NULL ) ); break;
+          default: dst.set( (char*)scalar ); break; // null is kept as a string for backwards compatibility
+        }
+      }
+
+
+      /*\
+       * @brief yaml_node_t deconstructor => JsonVariant
+       *
+       * Input: yaml_document_t
+       * Output: ArduinoJSON JsonVariant, children are created in place
+       *
+      \*/
+      static DeserializationError yaml_node_to_json( yaml_document_t* document, yaml_node_t* yamlNode, JsonVariant dst, int depth )
+      {
+        switch (yamlNode->type) {
+          case YAML_SCALAR_NODE:
+            yaml_scalar_to_json( dst, SCALAR_c(yamlNode), yamlNode->data.scalar.style, yaml_node_classify( yamlNode ) );
+          break;
+          case YAML_SEQUENCE_NODE:
+          {
+            JsonArray array = dst.to<JsonArray>();
+            yaml_node_item_t * item_i;
+            for (item_i = yamlNode->data.sequence.items.start; item_i < yamlNode->data.sequence.items.top; ++item_i) {
+              yaml_node_to_json( document, yaml_document_get_node(document, *item_i), array.add<JsonVariant>(), depth+1 );
+            }
+          }
+          break;
+          case YAML_MAPPING_NODE:
+          {
+            JsonObject object = dst.to<JsonObject>();
+            yaml_node_pair_t* pair_i;
+            yaml_node_t* key;
+            yaml_node_t* value;
+            for (pair_i = yamlNode->data.mapping.pairs.start; pair_i < yamlNode->data.mapping.pairs.top; ++pair_i) {
+              key   = yaml_document_get_node(document, pair_i->key);
+              value = yaml_document_get_node(document, pair_i->value);
+              if (key->type != YAML_SCALAR_NODE) {
+                YAML_LOG_e("Mapping key is not scalar (line %lu, val=%s).", key->start_mark.line, SCALAR_c(value) );
+                continue;
+              }
+              yaml_node_to_json( document, value, object[SCALAR_s(key)].to<JsonVariant>(), depth+1 );
+            }
+          }
+          break;
+          case YAML_NO_NODE: YAML_LOG_e("YAML_NO_NODE");
+
+          break;
+          default: YAML_LOG_e("Unknown node type (line %lu).", yamlNode->start_mark.line); break;
+        }
+        return DeserializationError::Ok;
+      }
+
+
       /*\
        * @brief yaml_node_t deconstructor => JsonObject
        *
        * Input: yaml_document_t
        * Output: ArduinoJSON JsonObject
        *
+       * Without a nodename the node fills jsonNode, otherwise it is appended
+       * to the jsonNode[nodename] array (Sequence) or stored as jsonNode[nodename] (Map).
+       *
       \*/
       DeserializationError deserializeYml_JsonObject( yaml_document_t* document, yaml_node_t* yamlNode, JsonVariant jsonNode, YAMLNode::Type nt, const char *nodename, int depth )
       {
-        bool isRootNode = ( strlen(nodename)<=0 );
+        if( !nodename || !nodename[0] ) {
+          return yaml_node_to_json( document, yamlNode, jsonNode, depth );
+        }
+        switch( nt ) {
+          case YAMLNode::Type::Sequence: return yaml_node_to_json( document, yamlNode, jsonNode[(char*)nodename].add<JsonVariant>(), depth );
+          case YAMLNode::Type::Map:      return yaml_node_to_json( document, yamlNode, jsonNode[(char*)nodename].to<JsonVariant>(), depth );
+          default: YAML_LOG_e("Error invalid nesting type"); break;
+        }
+        return DeserializationError::InvalidInput;
+      }
+
+
+      /*\
+       * @brief Event driven YAML => JsonVariant builder
+       *
+       * Fills the destination straight from the parser events, the libyaml
+       * document is never composed so only the JsonDocument grows with the
+       * input. Anchored nodes are remembered and copied on alias, non scalar
+       * keys are skipped along with their value, only the first document
+       * is converted.
+       *
+      \*/
+      struct yaml_arduinojson_builder_t : public YAMLEventHandler
+      {
+        struct frame_t
+        {
+          JsonObject object; // when is_map
+          JsonArray array;   // otherwise
+          bool is_map;
+        };
+
+        struct anchor_t
+        {
+          String name;
+          JsonVariant value;         // null when the anchored node is a key
+          String text;               // anchored scalar value
+          yaml_scalar_style_t style;
+        };
+
+        JsonVariant root;
+        bool object_root;       // the root must be a mapping (JsonObject destination)
+        yaml_frame_stack_t<frame_t> stack;
+        int top = -1;
+        String key;             // pending mapping key
+        int skip_depth = 0;     // open collections being skipped
+        bool skip_value = false; // next node is the value of a skipped key
+        std::vector<anchor_t> anchors;
+        DeserializationError error = DeserializationError::Ok;
+
+        yaml_arduinojson_builder_t( JsonVariant dst, bool is_object ) : root(dst), object_root(is_object) { }
+
+        // true when the node starting now must be ignored
+        bool skip_node( bool is_key, bool is_collection )
+        {
+          if( skip_depth > 0 ) {
+            if( is_collection ) skip_depth++;
+            return true;
+          }
+          if( skip_value ) {
+            skip_value = false;
+            if( is_collection ) skip_depth = 1;
+            return true;
+          }
+          if( is_key && is_collection ) {
+            YAML_LOG_e("Mapping key is not scalar, skipping pair.");
+            skip_value = true;
+            skip_depth = 1;
+            return true;
+          }
+          return false;
+        }
+
+        // destination of the node starting now
+        JsonVariant slot()
+        {
+          if( top < 0 ) return root;
+          if( stack[top].is_map ) return stack[top].object[(char*)key.c_str()].to<JsonVariant>();
+          return stack[top].array.add<JsonVariant>();
+        }
+
+        const anchor_t* find_anchor( const char* name ) const
+        {
+          for( size_t i=anchors.size(); i-->0; ) { // most recent definition wins
+            if( anchors[i].name == name ) return &anchors[i];
+          }
+          return nullptr;
+        }
+
+        bool open( bool is_map, const char* anchor, bool is_key )
+        {
+          if( skip_node( is_key, true ) ) return true;
+          if( top < 0 && object_root && !is_map ) {
+            YAML_LOG_e("Root node is not a mapping");
+            error = DeserializationError::InvalidInput;
+            return false;
+          }
+          JsonVariant dst = slot();
+          frame_t &frame = stack[++top];
+          frame.is_map = is_map;
+          if( is_map ) frame.object = dst.to<JsonObject>();
+          else         frame.array  = dst.to<JsonArray>();
+          if( anchor ) anchors.push_back( { String(anchor), dst, String(), YAML_ANY_SCALAR_STYLE } );
+          return true;
+        }
 
-        switch (yamlNode->type) {
-          case YAML_SCALAR_NODE:
-          {
-            //int plain_implicit = (strcmp((char *)yamlNode->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
-            bool quoted_implicit = false; // (strcmp((char *)yamlNode->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
-
-            if( (strcmp((char *)yamlNode->tag, YAML_DEFAULT_SCALAR_TAG) == 0) ) {
-              switch( yamlNode->data.scalar.style )
-              {
-                case YAML_SINGLE_QUOTED_SCALAR_STYLE:
-                case YAML_DOUBLE_QUOTED_SCALAR_STYLE:
-                  quoted_implicit = true;
-                break;
-                default: break;
-              }
-            }
+        bool close()
+        {
+          if( skip_depth > 0 ) {
+            skip_depth--;
+            return true;
+          }
+          top--;
+          return true;
+        }
 
-            double number;
-            char* scalar;
-            char* end;
-            scalar = SCALAR_s(yamlNode);
-            number = strtod(scalar, &end);
-            bool is_double = false;
-            bool is_bool = false;
-            bool bool_value = false;
-            bool is_string = quoted_implicit || (end == scalar || *end);
-            if( is_string && yaml_node_is_bool( yamlNode, &bool_value ) ) {
-              is_bool = true;
-            }
-            if( SCALAR_Quoted(yamlNode) ) {
-              is_string = true;
-            }
-            if( !is_bool && !is_string ) {
-              is_double = String(scalar).indexOf(".") > 0;
-            }
-            switch( nt ) {
-              case YAMLNode::Type::Sequence:
-              {
-                JsonArray array = jsonNode[nodename];
-                if(is_bool)        array.add( bool_value );
-                else if(is_string) array.add( scalar );
-                else if(is_double) array.add( number );
-                else               array.add( (int64_t)number );
-              }
-              break;
-              case YAMLNode::Type::Map:
-                if(is_bool)        jsonNode[nodename] = bool_value;
-                else if(is_string) jsonNode[nodename] = scalar;
-                else if(is_double) jsonNode[nodename] = number;
-                else               jsonNode[nodename] = (int64_t)number;
-              break;
-              default: YAML_LOG_e("Error invalid nesting type"); break;
-            }
+        virtual bool onDocumentEnd() override { return false; } // first document only
+        virtual bool onMappingStart( const char* /*tag*/, const char* anchor, bool is_key ) override { return open( true, anchor, is_key ); }
+        virtual bool onSequenceStart( const char* /*tag*/, const char* anchor, bool is_key ) override { return open( false, anchor, is_key ); }
+        virtual bool onMappingEnd() override { return close(); }
+        virtual bool onSequenceEnd() override { return close(); }
+
+        virtual bool onScalar( const char* value, size_t length, yaml_scalar_style_t style, const char* /*tag*/, const char* anchor, bool is_key ) override
+        {
+          if( skip_node( is_key, false ) ) return true;
+          if( top < 0 && object_root ) {
+            YAML_LOG_e("Root node is not a mapping");
+            error = DeserializationError::InvalidInput;
+            return false;
           }
-          break;
-          case YAML_SEQUENCE_NODE:
-          {
-            JsonArray tmpArray = jsonNode[(char*)nodename].to<JsonArray>();
-            yaml_node_item_t * item_i;
-            yaml_node_t *itemNode;
-            String _nodeItemName;
-            JsonObject tmpObj;
+          if( is_key ) {
+            key = value;
+            if( anchor ) anchors.push_back( { String(anchor), JsonVariant(), String(value), style } );
+            return true;
+          }
+          JsonVariant dst = slot();
+          yaml_scalar_to_json( dst, value, style, yaml_scalar_classify( value, length, style ) );
+          if( anchor ) anchors.push_back( { String(anchor), dst, String(value), style } );
+          return true;
+        }
 
-            for (item_i = yamlNode->data.sequence.items.start; item_i < yamlNode->data.sequence.items.top; ++item_i) {
-              itemNode = yaml_document_get_node(document, *item_i);
-              if( itemNode->type == YAML_MAPPING_NODE ) { // array of anonymous objects
-                tmpObj = tmpArray.add<JsonObject>(); // insert empty nested object
-                _nodeItemName = ROOT_NODE + String( nodename ) + String( tmpArray.size() ); // generate a temporary nodename for recursive call
-                tmpObj[(char*)_nodeItemName.c_str()].to<JsonObject>(); // use that nodename in a temporary nested object
-                deserializeYml_JsonObject( document, itemNode, tmpObj, YAMLNode::Type::Sequence, _nodeItemName.c_str(), depth+1 ); // go recursive using temporary node name
-                jsonNode[nodename].add( tmpObj[_nodeItemName.c_str()].as<JsonObject>() ); // copy+anonymize the temporary node
-                jsonNode[nodename].remove(tmpArray.size()-2); // remove temporary node
-              } else { // array of sequences or values
-                _nodeItemName = "" + String( nodename );
-                deserializeYml_JsonObject( document, itemNode, jsonNode, YAMLNode::Type::Sequence, _nodeItemName.c_str(), depth+1 );
-              }
-            }
+        virtual bool onAlias( const char* anchor, bool is_key ) override
+        {
+          if( skip_node( is_key, false ) ) return true;
+          const anchor_t* target = find_anchor( anchor );
+          if( !target ) {
+            YAML_LOG_e("Unknown anchor: %s", anchor );
+            error = DeserializationError::InvalidInput;
+            return false;
           }
-          break;
-          case YAML_MAPPING_NODE:
-          {
-            //JsonObject tmpNode = isRootNode ? jsonNode : jsonNode.createNestedObject((char*)nodename);
-            JsonObject tmpNode = isRootNode ? jsonNode.to<JsonObject>() : jsonNode[(char*)nodename].to<JsonObject>();
-            yaml_node_pair_t* pair_i;
-            yaml_node_t* key;
-            yaml_node_t* value;
-            for (pair_i = yamlNode->data.mapping.pairs.start; pair_i < yamlNode->data.mapping.pairs.top; ++pair_i) {
-              key   = yaml_document_get_node(document, pair_i->key);
-              value = yaml_document_get_node(document, pair_i->value);
-              if (key->type != YAML_SCALAR_NODE) {
-                YAML_LOG_e("Mapping key is not scalar (line %lu, val=%s).", key->start_mark.line, SCALAR_c(value) );
-                continue;
-              }
-              tmpNode[SCALAR_s(key)].to<JsonObject>(); // create nested object
-              deserializeYml_JsonObject( document, value, tmpNode, YAMLNode::Type::Map, SCALAR_c(key), depth+1 );
+          if( is_key ) {
+            if( target->style == YAML_ANY_SCALAR_STYLE ) { // aliased collection
+              YAML_LOG_e("Mapping key is not scalar, skipping pair.");
+              skip_value = true;
+            } else {
+              key = target->text;
             }
+            return true;
           }
-          break;
-          case YAML_NO_NODE: YAML_LOG_e("YAML_NO_NODE");
-
-          break;
-          default: YAML_LOG_e("Unknown node type (line %lu).", yamlNode->start_mark.line); break;
+          if( top < 0 ) return true; // a document can't start with an alias
+          if( target->value.isNull() && target->style != YAML_ANY_SCALAR_STYLE ) yaml_scalar_to_json( slot(), target->text.c_str(), target->style, yaml_scalar_classify( target->text.c_str(), target->text.length(), target->style ) );
+          else                                                                   slot().set( target->value );
+          return true;
         }
+      };
+
+
+      /*\
+       * @brief YAML stream/string => JsonVariant
+       *
+       * Input: YAML or JSON source
+       * Output: ArduinoJSON JsonVariant, a JsonObject when is_object is true
+       *
+      \*/
+      template <typename Source>
+      static DeserializationError deserializeYml_JsonVariant( JsonVariant dst, bool is_object, Source &src )
+      {
+        yaml_arduinojson_builder_t builder( dst, is_object );
+        int ret = libyaml_native::deserializeYml( builder, src );
+        if( builder.error ) return builder.error;
+        if( ret < 0 ) return DeserializationError::InvalidInput;
         return DeserializationError::Ok;
       }
 
@@ -1156,7 +3964,7 @@ namespace YAML
        * Output: YAML Stream
        *
       \*/
-      size_t serializeYml_JsonVariant( JsonVariant root, Stream &out, int depth, YAMLNode::Type nt )
+      size_t serializeYml_JsonVariant( JsonVariant root, yaml_output_buffer_t *out, const yaml_serializer_context_t* ctx, int depth, YAMLNode::Type nt )
       {
         int parent_level = depth>0?depth-1:0;
         size_t out_size = 0;
@@ -1164,19 +3972,28 @@ namespace YAML
           JsonArray array = root;
           for( size_t i=0; i<array.size(); i++ ) {
             size_t child_depth = array[i].is<JsonObject>() ? depth+1 : depth-1;
-            out_size += serializeYml_JsonVariant(array[i], out, child_depth, YAMLNode::Type::Sequence);
+            out_size += serializeYml_JsonVariant(array[i], out, ctx, child_depth, YAMLNode::Type::Sequence);
           }
         } else if (root.is<JsonObject>()) {
           JsonObject object = root;
           int i = 0;
           for (JsonPair pair : object) {
             bool is_seqfirst = (i++==0 && nt==YAMLNode::Type::Sequence);
-            out_size += out.printf("\n%s%s%s: ", is_seqfirst ? indent(parent_level, YAML::YAML_INDENT) : indent(depth, YAML::YAML_INDENT), is_seqfirst ? index() : "", pair.key().c_str() );
-            out_size += serializeYml_JsonVariant( pair.value(), out, depth+1, YAMLNode::Type::Map );
+            out_size += out->write('\n');
+            out_size += ctx->indent( out, is_seqfirst ? parent_level : depth, OUTPUT_YAML );
+            if( is_seqfirst ) out_size += ctx->index( out );
+            out_size += out->print( pair.key().c_str() );
+            out_size += out->write(": ", 2);
+            out_size += serializeYml_JsonVariant( pair.value(), out, ctx, depth+1, YAMLNode::Type::Map );
           }
         } else if( !root.isNull() ) {
-          if( nt == YAMLNode::Type::Sequence ) out_size += out.printf("\n%s%s",  indent(depth, YAML::YAML_INDENT), index() );
-          yaml_multiline_escape_string(&out, root.as<String>().c_str(), root.as<String>().length(), &out_size, depth);
+          if( nt == YAMLNode::Type::Sequence ) {
+            out_size += out->write('\n');
+            out_size += ctx->indent( out, depth, OUTPUT_YAML );
+            out_size += ctx->index( out );
+          }
+          String value = root.as<String>();
+          yaml_multiline_escape_string(out, value.c_str(), value.length(), &out_size, depth, ctx);
         } else {
           YAML_LOG_e("Error, root is null");
         }
@@ -1184,6 +4001,21 @@ namespace YAML
       }
 
 
+      /*\
+       * @brief JsonVariant deconstructor => YAML stream
+       *
+       * Input: ArduinoJSON JsonVariant
+       * Output: YAML Stream
+       *
+      \*/
+      size_t serializeYml_JsonVariant( JsonVariant root, Stream &out, int depth, YAMLNode::Type nt )
+      {
+        yaml_output_buffer_t out_buffer( &out );
+        yaml_serializer_context_t ctx = CreateSerializerContext( OUTPUT_YAML );
+        return serializeYml_JsonVariant( root, &out_buffer, &ctx, depth, nt );
+      }
+
+
       /*\
        * @brief JsonVariant serializer => YAML string
        *
@@ -1220,8 +4052,8 @@ namespace YAML
       \*/
       DeserializationError deserializeYml( JsonDocument &dest_doc, Stream &src )
       {
-        JsonObject dest_obj = dest_doc.to<JsonObject>();
-        auto ret = YAMLToArduinoJson::toJsonObject( src, dest_obj );
+        auto ret = deserializeYml_JsonVariant( dest_doc.to<JsonVariant>(), false, src );
+        if( !ret && dest_doc.overflowed() ) return DeserializationError::NoMemory;
         return ret;
       }
 
@@ -1235,8 +4067,8 @@ namespace YAML
       \*/
       DeserializationError deserializeYml( JsonDocument &dest_doc, const char* src )
       {
-        JsonObject dest_obj = dest_doc.to<JsonObject>();
-        auto ret = YAMLToArduinoJson::toJsonObject( src, dest_obj );
+        auto ret = deserializeYml_JsonVariant( dest_doc.to<JsonVariant>(), false, src );
+        if( !ret && dest_doc.overflowed() ) return DeserializationError::NoMemory;
         return ret;
       }
 
@@ -1280,9 +4112,7 @@ namespace YAML
     \*/
     DeserializationError YAMLToArduinoJson::toJsonObject( Stream &src, JsonObject& output )
     {
-      YAMLNode yamlnode = YAMLNode::loadStream( src );
-      auto ret = deserializeYml_JsonObject(yamlnode.getDocument(), yamlnode.getNode(), output);
-      return ret;
+      return deserializeYml_JsonVariant( output, true, src );
     }
 
 
@@ -1295,9 +4125,7 @@ namespace YAML
     \*/
     DeserializationError YAMLToArduinoJson::toJsonObject( const char* src, JsonObject& output )
     {
-      YAMLNode yamlnode = YAMLNode::loadString( src );
-      auto ret = deserializeYml_JsonObject(yamlnode.getDocument(), yamlnode.getNode(), output);
-      return ret;
+      return deserializeYml_JsonVariant( output, true, src );
     }
 
 
@@ -1311,6 +4139,40 @@ namespace YAML
 
     namespace libyaml_cjson
     {
+      /*\
+       * @brief Scalar node to cJSON type
+       *
+       * Returns cJSON_String, cJSON_True, cJSON_False or cJSON_Number,
+       * the parsed value is stored in *number for the latter.
+       *
+      \*/
+      static int yaml_scalar_cjson_type( yaml_node_t * yamlNode, double *number )
+      {
+        bool quoted_implicit = (strcmp((char *)yamlNode->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
+
+        if( quoted_implicit ) {
+          switch( yamlNode->data.scalar.style )
+          {
+            case YAML_SINGLE_QUOTED_SCALAR_STYLE:
+            case YAML_DOUBLE_QUOTED_SCALAR_STYLE:
+              return cJSON_String;
+            default: break;
+          }
+        }
+
+        switch( yaml_node_classify( yamlNode ) ) {
+          case YAML_SCALAR_CLASS_TRUE:  return cJSON_True;
+          case YAML_SCALAR_CLASS_FALSE: return cJSON_False;
+          case YAML_SCALAR_CLASS_INT:
+          case YAML_SCALAR_CLASS_FLOAT:
+          case YAML_SCALAR_CLASS_HEX:
+            *number = strtod(SCALAR_c(yamlNode), NULL);
+            return cJSON_Number;
+          default: return cJSON_String; // null is kept as a string for backwards compatibility
+        }
+      }
+
+
       /*\
        * @brief yaml_node_t deconstructor => cJSON Object
        *
@@ -1330,37 +4192,13 @@ namespace YAML
           break;
           case YAML_SCALAR_NODE:
           {
-            //int plain_implicit = (strcmp((char *)yamlNode->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
-            //int quoted_implicit = (strcmp((char *)yamlNode->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
-
-            bool quoted_implicit = (strcmp((char *)yamlNode->tag, YAML_DEFAULT_SCALAR_TAG) == 0);
-
-            if( quoted_implicit ) {
-              switch( yamlNode->data.scalar.style )
-              {
-                case YAML_SINGLE_QUOTED_SCALAR_STYLE:
-                case YAML_DOUBLE_QUOTED_SCALAR_STYLE:
-                  quoted_implicit = true;
-                break;
-                default:
-                  quoted_implicit = false;
-                break;
-              }
-            }
-
             double number;
-            char * scalar;
-            char * end;
-            scalar = SCALAR_s(yamlNode);
-            number = strtod(scalar, &end);
-            if( quoted_implicit || (end == scalar || *end) ) { // string or bool
-              bool bool_value;
-              if( yaml_node_is_bool( yamlNode, &bool_value ) ) {
-                object = cJSON_CreateBool( bool_value );
-              } else {
-                object = cJSON_CreateString( scalar );
-              }
-            } else object = cJSON_CreateNumber(number); // leaky !!
+            switch( yaml_scalar_cjson_type( yamlNode, &number ) ) {
+              case cJSON_True:   object = cJSON_CreateBool( true ); break;
+              case cJSON_False:  object = cJSON_CreateBool( false ); break;
+              case cJSON_String: object = cJSON_CreateString( SCALAR_c(yamlNode) ); break;
+              default:           object = cJSON_CreateNumber( number ); break;
+            }
           }
           break;
           case YAML_SEQUENCE_NODE:
@@ -1397,6 +4235,209 @@ namespace YAML
       }
 
 
+      /*\
+       * @brief Single block cJSON builder
+       *
+       * A first pass over the document counts the items and the scalar bytes,
+       * then every cJSON item and string is carved from one cJSON_malloc() block
+       * with the root item at its start. Keys are cJSON_StringIsConst and string
+       * values cJSON_IsReference, so nothing but the block itself is owned.
+       *
+      \*/
+      struct yaml_cjson_pool_t
+      {
+        yaml_document_t* document;
+        size_t items = 0;
+        size_t bytes = 0;
+        cJSON* next_item = nullptr;
+        char* next_byte = nullptr;
+
+        void count( yaml_node_t* yamlNode )
+        {
+          switch (yamlNode->type) {
+            case YAML_NO_NODE: items++; break;
+            case YAML_SCALAR_NODE: items++; bytes += yamlNode->data.scalar.length+1; break;
+            case YAML_SEQUENCE_NODE:
+              items++;
+              for (yaml_node_item_t* item_i = yamlNode->data.sequence.items.start; item_i < yamlNode->data.sequence.items.top; ++item_i) {
+                count( yaml_document_get_node(document, *item_i) );
+              }
+            break;
+            case YAML_MAPPING_NODE:
+              items++;
+              for (yaml_node_pair_t* pair_i = yamlNode->data.mapping.pairs.start; pair_i < yamlNode->data.mapping.pairs.top; ++pair_i) {
+                yaml_node_t* key = yaml_document_get_node(document, pair_i->key);
+                if (key->type != YAML_SCALAR_NODE) continue;
+                bytes += key->data.scalar.length+1;
+                count( yaml_document_get_node(document, pair_i->value) );
+              }
+            break;
+            default: break;
+          }
+        }
+
+        char* copy( yaml_node_t* scalarNode )
+        {
+          char* str = next_byte;
+          memcpy( str, scalarNode->data.scalar.value, scalarNode->data.scalar.length );
+          str[scalarNode->data.scalar.length] = '\0';
+          next_byte += scalarNode->data.scalar.length+1;
+          return str;
+        }
+
+        // appends child to the item list of parent
+        static void attach( cJSON* parent, cJSON* child )
+        {
+          if( !parent->child ) {
+            parent->child = child;
+          } else {
+            parent->child->prev->next = child;
+            child->prev = parent->child->prev;
+          }
+          parent->child->prev = child;
+        }
+
+        cJSON* build( yaml_node_t* yamlNode )
+        {
+          cJSON* object;
+          switch (yamlNode->type) {
+            case YAML_NO_NODE:
+              object = next_item++;
+              object->type = cJSON_Object;
+            break;
+            case YAML_SCALAR_NODE:
+            {
+              object = next_item++;
+              double number;
+              object->type = yaml_scalar_cjson_type( yamlNode, &number );
+              if( object->type == cJSON_String ) {
+                object->type |= cJSON_IsReference;
+                object->valuestring = copy( yamlNode );
+              } else {
+                next_byte += yamlNode->data.scalar.length+1; // keep the count pass in sync
+                if( object->type == cJSON_Number ) { // same saturation as cJSON_CreateNumber()
+                  object->valuedouble = number;
+                  if( number >= INT_MAX )      object->valueint = INT_MAX;
+                  else if( number <= INT_MIN ) object->valueint = INT_MIN;
+                  else                         object->valueint = (int)number;
+                }
+              }
+            }
+            break;
+            case YAML_SEQUENCE_NODE:
+              object = next_item++;
+              object->type = cJSON_Array;
+              for (yaml_node_item_t* item_i = yamlNode->data.sequence.items.start; item_i < yamlNode->data.sequence.items.top; ++item_i) {
+                cJSON* child = build( yaml_document_get_node(document, *item_i) );
+                if( child ) attach( object, child );
+              }
+            break;
+            case YAML_MAPPING_NODE:
+              object = next_item++;
+              object->type = cJSON_Object;
+              for (yaml_node_pair_t* pair_i = yamlNode->data.mapping.pairs.start; pair_i < yamlNode->data.mapping.pairs.top; ++pair_i) {
+                yaml_node_t* key = yaml_document_get_node(document, pair_i->key);
+                if (key->type != YAML_SCALAR_NODE) {
+                  YAML_LOG_e("Mapping key is not scalar (line %lu).", key->start_mark.line);
+                  continue;
+                }
+                char* key_str = copy( key );
+                cJSON* child = build( yaml_document_get_node(document, pair_i->value) );
+                if( !child ) continue;
+                child->string = key_str;
+                child->type |= cJSON_StringIsConst;
+                attach( object, child );
+              }
+            break;
+            default:
+              YAML_LOG_e("Unknown node type (line %lu).", yamlNode->start_mark.line);
+              object = NULL;
+          }
+          return object;
+        }
+      };
+
+
+      /*\
+       * @brief yaml_node_t deconstructor => pooled cJSON Object
+       *
+       * Input: yaml_document_t
+       * Returns: cJSON object allocated as a single block, must be released
+       * with deleteYml_cJSONPool() and never modified in place.
+       * Keys are not copied by cJSON_Duplicate(): duplicates share them with
+       * the block and must be deleted before it.
+       *
+      \*/
+      cJSON* deserializeYml_cJSONPool(yaml_document_t * document, yaml_node_t * yamlNode)
+      {
+        assert( yamlNode );
+        assert( document );
+        yaml_cjson_pool_t pool;
+        pool.document = document;
+        pool.count( yamlNode );
+        if( pool.items == 0 ) {
+          YAML_LOG_e("Unknown node type (line %lu).", yamlNode->start_mark.line);
+          return NULL;
+        }
+        size_t items_size = pool.items*sizeof(cJSON);
+        void* block = cJSON_malloc( items_size + pool.bytes );
+        if( !block ) {
+          YAML_LOG_e("Failed to allocate %u bytes", (unsigned)(items_size + pool.bytes) );
+          return NULL;
+        }
+        memset( block, 0, items_size );
+        pool.next_item = (cJSON*)block;
+        pool.next_byte = (char*)block + items_size;
+        return pool.build( yamlNode );
+      }
+
+
+      /*\
+       * @brief pooled cJSON object release
+       *
+       * Input: root returned by deserializeYml_cJSONPool() or deserializeYmlPool()
+       *
+      \*/
+      void deleteYml_cJSONPool( cJSON* root )
+      {
+        if( root ) cJSON_free( root );
+      }
+
+
+      /*\
+       * @brief cJSON scalar value as text
+       *
+       * Same output as cJSON_PrintUnformatted() for scalars but without the
+       * heap round-trip: numbers are formatted in number_buffer (26 bytes),
+       * strings and raw values are returned as is.
+       *
+      \*/
+      static const char* cjson_value_string( const cJSON* item, char* number_buffer )
+      {
+        switch( item->type & 0xFF ) {
+          case cJSON_NULL:  return "null";
+          case cJSON_False: return "false";
+          case cJSON_True:  return "true";
+          case cJSON_Number:
+          {
+            double d = item->valuedouble;
+            if( isnan(d) || isinf(d) ) return "null";
+            if( d == (double)item->valueint ) {
+              snprintf( number_buffer, 26, "%d", item->valueint );
+            } else {
+              // 15 digits avoid nonsignificant trailing digits, 17 if the value can't be recovered
+              snprintf( number_buffer, 26, "%1.15g", d );
+              double test = strtod( number_buffer, NULL );
+              double max_val = fabs(test) > fabs(d) ? fabs(test) : fabs(d);
+              if( !( fabs(test - d) <= max_val * DBL_EPSILON ) ) snprintf( number_buffer, 26, "%1.17g", d );
+            }
+            return number_buffer;
+          }
+          default: return item->valuestring; // cJSON_String, cJSON_Raw
+        }
+      }
+
+
       /*\
        * @brief cJSON deconstructor => YAML stream
        *
@@ -1404,49 +4445,68 @@ namespace YAML
        * Output: YAML Stream
        *
       \*/
-      size_t serializeYml_cJSONObject( cJSON *root, Stream &out, int depth, YAMLNode::Type nt )
+      size_t serializeYml_cJSONObject( cJSON *root, yaml_output_buffer_t *out, const yaml_serializer_context_t* ctx, int depth, YAMLNode::Type nt )
       {
         assert(root);
         int parent_level = depth>0?depth-1:0;
         size_t out_size = 0;
 
-        if ( root->type == cJSON_Array ) {
+        int type = root->type & 0xFF; // ignore cJSON_IsReference/cJSON_StringIsConst flags
+        if ( type == cJSON_Array ) {
           cJSON *current_element = root->child;
           while (current_element != NULL) {
-            size_t child_depth = current_element->type == cJSON_Object ? depth+1 : depth-1;
-            out_size += serializeYml_cJSONObject( current_element, out, child_depth, YAMLNode::Type::Sequence );
+            size_t child_depth = (current_element->type & 0xFF) == cJSON_Object ? depth+1 : depth-1;
+            out_size += serializeYml_cJSONObject( current_element, out, ctx, child_depth, YAMLNode::Type::Sequence );
             current_element = current_element->next;
           }
-        } else if (root->type == cJSON_Object ) {
+        } else if ( type == cJSON_Object ) {
           cJSON *current_item = root->child;
           int i = 0;
           while (current_item) {
             bool is_seqfirst = (i++==0 && nt==YAMLNode::Type::Sequence);
             char* key = current_item->string;
-            out_size += out.printf("\n%s%s%s: ", is_seqfirst ? indent(parent_level, YAML::YAML_INDENT) : indent(depth, YAML::YAML_INDENT), is_seqfirst ? index() : "", key );
-            out_size += serializeYml_cJSONObject( current_item, out, depth+1, YAMLNode::Type::Map );
+            out_size += out->write('\n');
+            out_size += ctx->indent( out, is_seqfirst ? parent_level : depth, OUTPUT_YAML );
+            if( is_seqfirst ) out_size += ctx->index( out );
+            out_size += out->print( key );
+            out_size += out->write(": ", 2);
+            out_size += serializeYml_cJSONObject( current_item, out, ctx, depth+1, YAMLNode::Type::Map );
             current_item = current_item->next;
           }
         } else {
-          char *value = root->valuestring;
-          bool value_needs_free = false; // at this point value is just a pointer to root object property
-          if( !value ) { // not a string, maybe number or a bool
-            value = cJSON_PrintUnformatted( root ); // now the value has been malloc'ed, will need free
-            value_needs_free = true;
-            if( !value ) {
-              YAML_LOG_e("node has no value!");
-              return 0;
-            }
+          char number_buffer[26]; // same size as cJSON print_number()
+          const char *value = cjson_value_string( root, number_buffer );
+          if( !value ) {
+            YAML_LOG_e("node has no value!");
+            return 0;
           }
           size_t value_len = strlen(value);
-          if( nt == YAMLNode::Type::Sequence ) out_size += out.printf("\n%s%s",  indent(depth, YAML::YAML_INDENT), index() );
-          yaml_multiline_escape_string(&out, value, value_len, &out_size, depth);
-          if( value_needs_free ) cJSON_free( value );
+          if( nt == YAMLNode::Type::Sequence ) {
+            out_size += out->write('\n');
+            out_size += ctx->indent( out, depth, OUTPUT_YAML );
+            out_size += ctx->index( out );
+          }
+          yaml_multiline_escape_string(out, value, value_len, &out_size, depth, ctx);
         }
         return out_size;
       }
 
 
+      /*\
+       * @brief cJSON deconstructor => YAML stream
+       *
+       * Input: cJSON object
+       * Output: YAML Stream
+       *
+      \*/
+      size_t serializeYml_cJSONObject( cJSON *root, Stream &out, int depth, YAMLNode::Type nt )
+      {
+        yaml_output_buffer_t out_buffer( &out );
+        yaml_serializer_context_t ctx = CreateSerializerContext( OUTPUT_YAML );
+        return serializeYml_cJSONObject( root, &out_buffer, &ctx, depth, nt );
+      }
+
+
       /*\
        * @brief cJSON object to YAML string
        *
@@ -1521,6 +4581,51 @@ namespace YAML
         return *dest_obj != NULL ? 1 : -1;
       }
 
+      /*\
+       * @brief string to pooled cJSON object
+       *
+       * Input: YAML string
+       * Output: ptr to cJSON object, release with deleteYml_cJSONPool()
+       *
+      \*/
+      int deserializeYmlPool( cJSON** dest_obj, const char* src_yaml_str )
+      {
+        YAMLNode yamlnode = YAMLNode::loadString( src_yaml_str );
+        *dest_obj = yamlnode.isNull() ? NULL : deserializeYml_cJSONPool( yamlnode.getDocument(), yamlnode.getNode() );
+        return *dest_obj != NULL ? 1 : -1;
+      }
+
+
+      /*\
+       * @brief stream to pooled cJSON object
+       *
+       * Input: YAML stream
+       * Output: ptr to cJSON object, release with deleteYml_cJSONPool()
+       *
+      \*/
+      int deserializeYmlPool( cJSON** dest_obj, Stream &src_stream )
+      {
+        YAMLNode yamlnode = YAMLNode::loadStream( src_stream );
+        *dest_obj = yamlnode.isNull() ? NULL : deserializeYml_cJSONPool( yamlnode.getDocument(), yamlnode.getNode() );
+        return *dest_obj != NULL ? 1 : -1;
+      }
+
+
+      /*\
+       * @brief yaml_document to pooled cJSON object
+       *
+       * Input: yaml_document_t
+       * Output: ptr to cJSON object, release with deleteYml_cJSONPool()
+       *
+      \*/
+      int deserializeYmlPool( cJSON** dest_obj, yaml_document_t* src_document )
+      {
+        yaml_node_t* node;
+        if (node = yaml_document_get_root_node(src_document), !node) { YAML_LOG_w("No document defined."); return -1; }
+        *dest_obj = deserializeYml_cJSONPool( src_document, node );
+        return *dest_obj != NULL ? 1 : -1;
+      }
+
       /*\
        * @brief yaml_document to cJSON object
        *
@@ -1549,11 +4654,20 @@ namespace YAML
 
 
 
+      /*\
+       * @brief Default constructor
+       *
+      \*/
+      i18n_t::i18n_t() : cache_size( I18N_CACHE_SIZE )
+      {
+      }
+
+
       /*\
        * @brief Constructor with YAMLNode
        *
       \*/
-      i18n_t::i18n_t( const char* localeStr, YAMLNode &node )
+      i18n_t::i18n_t( const char* localeStr, YAMLNode &node ) : cache_size( I18N_CACHE_SIZE )
       {
         setLocale( localeStr, node );
       };
@@ -1582,7 +4696,7 @@ namespace YAML
          * Accepts any fs::FS
          *
         \*/
-        i18n_t::i18n_t( fs::FS *_fs)
+        i18n_t::i18n_t( fs::FS *_fs) : cache_size( I18N_CACHE_SIZE )
         {
           setFS( _fs);
         }
@@ -1597,6 +4711,7 @@ namespace YAML
       i18n_t::~i18n_t()
       {
         clearLocale();
+        free( cache );
       }
 
 
@@ -1622,7 +4737,62 @@ namespace YAML
       \*/
       const char* i18n_t::gettext( const char* l10npath, char delimiter )
       {
-        return l10n.gettext( l10npath, delimiter );
+        if( !l10npath || cache_size == 0 ) return l10n.gettext( l10npath, delimiter );
+        if( !cache ) {
+          cache = (cache_entry_t*)calloc( cache_size, sizeof(cache_entry_t) );
+          if( !cache ) { // not critical, stay uncached
+            YAML_LOG_w("Unable to allocate %u gettext() cache slots", (unsigned)cache_size );
+            cache_size = 0;
+            return l10n.gettext( l10npath, delimiter );
+          }
+        }
+        uint32_t hash = yaml_key_hash( l10npath, strlen(l10npath) );
+        cache_entry_t &entry = cache[hash % cache_size];
+        if( entry.path == l10npath && entry.hash == hash && entry.delimiter == delimiter ) {
+          cache_hits++;
+          return entry.value;
+        }
+        cache_misses++;
+        entry = { l10npath, hash, delimiter, l10n.gettext( l10npath, delimiter ) };
+        return entry.value;
+      }
+
+
+      /*\
+       * @brief Resize gettext() cache
+       *
+       * Slots are allocated on the next gettext() call, 0 disables the cache.
+       *
+      \*/
+      void i18n_t::setCacheSize( size_t slots )
+      {
+        free( cache );
+        cache = nullptr;
+        cache_size = slots;
+      }
+
+
+      /*\
+       * @brief Empty gettext() cache
+       *
+       * Cached values point to the l10n document, this must be
+       * called whenever l10n is reassigned. Counters are kept.
+       *
+      \*/
+      void i18n_t::clearCache()
+      {
+        if( cache ) memset( cache, 0, cache_size*sizeof(cache_entry_t) );
+      }
+
+
+      /*\
+       * @brief Reset gettext() cache hits/misses counters
+       *
+      \*/
+      void i18n_t::resetCacheStats()
+      {
+        cache_hits = 0;
+        cache_misses = 0;
       }
 
 
@@ -1764,6 +4934,7 @@ namespace YAML
       bool i18n_t::setLocale( const char* localeStr, YAMLNode &node )
       {
         if( presetLocale( localeStr ) ) {
+          clearCache();
           if( node.size()==1 ) { // only one root node, does it match locale or language ?
             if( !node[localeStr].isNull() ) l10n=node[localeStr];
             if( !node[locale.language].isNull() )   l10n=node[locale.language];
@@ -1784,6 +4955,7 @@ namespace YAML
       \*/
       bool i18n_t::loadLocaleStream( Stream& stream, size_t size )
       {
+        clearCache();
         l10n = YAMLNode::loadStream( stream );
         return !l10n.isNull();
       }
@@ -47,6 +47,7 @@ extern "C"
 }
 #include <memory>    // for std::shared_ptr
 #include <string>    // for std::string
+#include <vector>    // for std::vector
 #include <stdexcept> // for std::runtime_error
 
 
@@ -110,6 +111,44 @@ extern "C"
 #define JSON_FOLDING_DEPTH 4  // lame fact: folds on objects, not on arrays
 #define MAX_INDENT_DEPTH 16   // max amount of space/tab per indent level, doesn't seem reasonable to do more on embedded projects
 
+#if !defined YAML_INDENT_TABLE_SIZE
+  #define YAML_INDENT_TABLE_SIZE (MAX_INDENT_DEPTH*16) // precomputed indentation chars (16 levels at max width), deeper levels are written in slices
+#endif
+
+#if !defined YAML_ARENA_CHUNK_SIZE
+  #define YAML_ARENA_CHUNK_SIZE 1024 // default size of the memory chunks used by document arenas
+#endif
+
+#if !defined YAML_OUTPUT_BUFFER_SIZE
+  #define YAML_OUTPUT_BUFFER_SIZE 128 // serializers output buffer, allocated on the stack
+#endif
+
+#if !defined YAML_STREAM_MAX_DEPTH
+  #define YAML_STREAM_MAX_DEPTH 32 // nesting levels kept on the stack by event driven (de)serializers, deeper ones are allocated
+#endif
+
+#if !defined I18N_CACHE_SIZE
+  #define I18N_CACHE_SIZE 16 // default i18n_t::gettext() cache slots, 0=disabled, see i18n_t::setCacheSize()
+#endif
+
+#if defined ESP32
+  #define YAML_SNAPSHOT_MAP_PARTITION // YAMLNodeView::mapPartition()
+#elif defined __linux__ || defined __APPLE__
+  #define YAML_SNAPSHOT_MAP_FILE // YAMLNodeView::mapFile()
+#endif
+
+#if !defined YAML_KEY_INDEX_MIN_PAIRS
+  #define YAML_KEY_INDEX_MIN_PAIRS 8 // mappings smaller than this are scanned linearly, bigger ones are covered by the key index
+#endif
+
+#if !defined YAML_DISABLE_SIMD // define this from sketch to force the portable word-at-a-time string scanning
+  #if defined __SSE2__
+    #define YAML_SIMD_SSE2 // x86 hosts
+  #elif defined __ARM_NEON
+    #define YAML_SIMD_NEON // aarch64 hosts, Cortex-A
+  #endif
+#endif
+
 
 namespace YAML
 {
@@ -121,6 +160,7 @@ namespace YAML
   __attribute__((unused)) static int YAMLIndentDepth = 2;
   __attribute__((unused)) static String YAML_INDENT_STRING = "  ";
   __attribute__((unused)) static String JSON_INDENT_STRING = "\t";
+  __attribute__((unused)) static size_t DocumentArenaChunkSize = 0; // 0 = disabled
 
   #define JSON_INDENT JSON_INDENT_STRING.c_str()
   #define YAML_INDENT YAML_INDENT_STRING.c_str()
@@ -132,6 +172,15 @@ namespace YAML
 
   void setYAMLIndent( int spaces_per_indent=2 ); // min=2, max=16
   void setJSONIndent( const char* spaces_or_tabs=JSON_SCALAR_TAB, int folding_depth=JSON_FOLDING_DEPTH );
+  void setDocumentArena( size_t chunk_size=YAML_ARENA_CHUNK_SIZE ); // 0=disabled, min=256
+
+  // allocation/throughput counters, requires YAML_ENABLE_STATS build flag
+  namespace stats
+  {
+    bool enabled();
+    yaml_stats_t get(); // all zeros when disabled
+    void reset();       // live heap bytes are kept, peak restarts from there
+  };
 
   namespace helpers
   {
@@ -140,21 +189,69 @@ namespace YAML
     struct ParserDelete;
     struct yaml_traverser_t;
     struct yaml_stream_handler_data_t;
+    struct yaml_key_index_t;
+    struct yaml_arena_t;
+    struct yaml_output_buffer_t;
+    struct yaml_serializer_context_t;
+    struct yaml_snapshot_t;
     // available output formats
     enum OutputFormat_t { OUTPUT_YAML, OUTPUT_JSON, OUTPUT_JSON_PRETTY };
-    std::shared_ptr<yaml_document_t> CreateDocument();
+    // scalar content classes, see yaml_scalar_classify()
+    enum yaml_scalar_class_t { YAML_SCALAR_CLASS_STRING, YAML_SCALAR_CLASS_NULL, YAML_SCALAR_CLASS_TRUE, YAML_SCALAR_CLASS_FALSE, YAML_SCALAR_CLASS_INT, YAML_SCALAR_CLASS_FLOAT, YAML_SCALAR_CLASS_HEX };
+    std::shared_ptr<yaml_document_t> CreateDocument( yaml_arena_t* arena=nullptr );
+    yaml_arena_t* CreateArena();
+    yaml_arena_t* CreateArena( const char* insitu_buffer, size_t insitu_size );
+    std::shared_ptr<yaml_key_index_t> CreateKeyIndex( yaml_document_t* document );
+    yaml_serializer_context_t CreateSerializerContext( OutputFormat_t format );
+    uint32_t yaml_key_hash( const char* str, size_t len );
+    uint32_t yaml_key_hash( int mapping_id, uint32_t key_hash );
+    uint32_t yaml_key_hash( int mapping_id, const char* str, size_t len );
+    bool yaml_key_index_build( yaml_document_t* document, yaml_key_index_t* index );
+    yaml_node_t* yaml_key_index_find( yaml_document_t* document, yaml_key_index_t* index, yaml_node_t* mapping, const char* str, size_t len );
+    yaml_node_t* yaml_key_index_find( yaml_document_t* document, yaml_key_index_t* index, yaml_node_t* mapping, const char* str, size_t len, uint32_t key_hash );
     bool is_filled_with( char needle, const char* haystack );
     bool utf8_equal( const char *str1, size_t len1, const char *str2, size_t len2 );
     int _yaml_stream_reader(void *data, unsigned char *buffer, size_t size, size_t *size_read);
-    const char* indent( int size, const char* indstr=YAML::YAML_INDENT );
-    const char* index();
+    yaml_scalar_class_t yaml_scalar_classify( const char* scalar, size_t length, yaml_scalar_style_t style );
+    yaml_scalar_class_t yaml_node_classify( yaml_node_t * yamlNode );
+    void yaml_document_classify( yaml_document_t* document );
     bool string_has_truthy_value( String &_scalar );
     bool string_has_falsy_value( String &_scalar );
     bool string_has_bool_value( String &_scalar, bool *value_out );
     bool yaml_node_is_bool( yaml_node_t * yamlNode, bool *value_out );
+    bool yaml_scalar_is_bool( const char* scalar, yaml_scalar_style_t style, bool *value_out );
     void yaml_multiline_escape_string( Stream* stream, const char* str, size_t length, size_t *bytes_out, size_t depth );
+    void yaml_multiline_escape_string( yaml_output_buffer_t* out, const char* str, size_t length, size_t *bytes_out, size_t depth, const yaml_serializer_context_t* ctx );
+    void yaml_multiline_escape_string( yaml_output_buffer_t* out, const char* str, size_t length, const char* tag, yaml_scalar_style_t style, size_t *bytes_out, size_t depth, const yaml_serializer_context_t* ctx );
     void yaml_escape_quoted_string( Stream* stream, const char* str, size_t length, size_t *bytes_out );
+    void yaml_escape_quoted_string( yaml_output_buffer_t* out, const char* str, size_t length, size_t *bytes_out );
     bool scalar_needs_quote( yaml_node_t *node );
+    bool scalar_needs_quote( const char* scalar, const char* tag, yaml_scalar_style_t style );
+
+    /*\
+     * @brief Compiled gettext path
+     *
+     * Splits a delimited path (e.g. "a:b:3:c") once, with key hashes and sequence
+     * indexes precomputed, so it can be resolved many times without allocating.
+     *
+    \*/
+    struct yaml_path_t
+    {
+      struct segment_t
+      {
+        size_t offset;  // key position in 'keys'
+        size_t length;  // key length
+        uint32_t hash;  // yaml_key_hash( key, length )
+        int index;      // atoi( key ), used when the key is not found in a sequence parent
+      };
+      explicit yaml_path_t( const char* path, char delimiter=':' );
+      const char* c_str() const { return path.c_str(); }
+      const char* key( const segment_t &segment ) const { return keys.data() + segment.offset; }
+      std::string path;   // original path, returned by gettext() when not found
+      std::string keys;   // path copy with delimiters replaced by zeros
+      std::vector<segment_t> segments;
+      bool keys_only;     // no delimiter in path: single key lookup, no sequence index
+    };
   };
 
 
@@ -165,16 +262,34 @@ namespace YAML
     StringStream(String &s) : str(s), pos(0) {}
     virtual ~StringStream() {};
     virtual int available() { return str.length() - pos; }
-    virtual int read() { return pos < str.length() ? str[pos++] : -1; }
-    virtual int peek() { return pos < str.length() ? str[pos] : -1; }
+    virtual int read() { return pos < str.length() ? (uint8_t)str[pos++] : -1; }
+    virtual int peek() { return pos < str.length() ? (uint8_t)str[pos] : -1; }
     virtual size_t write(uint8_t c) { str += (char)c; return 1; }
+    virtual size_t write(const uint8_t *buffer, size_t size) { str.reserve(str.length()+size); for( size_t i=0;i<size;i++ ) str += (char)buffer[i]; return size; }
     virtual void flush() {}
+    using Print::write;
   private:
     String &str;
     unsigned int pos;
   };
 
 
+  // SAX style parser events, see deserializeYml( YAMLEventHandler&, ... ), return false to stop parsing
+  class YAMLEventHandler
+  {
+  public:
+    virtual ~YAMLEventHandler() {}
+    virtual bool onDocumentStart() { return true; }
+    virtual bool onDocumentEnd() { return true; }
+    virtual bool onMappingStart( const char* /*tag*/, const char* /*anchor*/, bool /*is_key*/ ) { return true; }
+    virtual bool onMappingEnd() { return true; }
+    virtual bool onSequenceStart( const char* /*tag*/, const char* /*anchor*/, bool /*is_key*/ ) { return true; }
+    virtual bool onSequenceEnd() { return true; }
+    virtual bool onScalar( const char* /*value*/, size_t /*length*/, yaml_scalar_style_t /*style*/, const char* /*tag*/, const char* /*anchor*/, bool /*is_key*/ ) { return true; }
+    virtual bool onAlias( const char* /*anchor*/, bool /*is_key*/ ) { return true; }
+  };
+
+
   namespace YAMLNode_Class
   {
 
@@ -184,6 +299,7 @@ namespace YAML
     class YAMLNode
     {
       std::shared_ptr<yaml_document_t> mDocument;
+      std::shared_ptr<yaml_key_index_t> mKeyIndex; // optional, built on first lookup, never modified afterwards
       yaml_node_t *mNode = nullptr;
     public:
       enum class Type {
@@ -204,12 +320,27 @@ namespace YAML
         mNode(node)
       {}
 
+      YAMLNode( std::shared_ptr<yaml_document_t> document, yaml_node_t *node, std::shared_ptr<yaml_key_index_t> keyindex ) :
+        mDocument(document),
+        mKeyIndex(keyindex),
+        mNode(node)
+      {}
+
       Type type() const;
 
       static YAMLNode loadString( const char *str );
       static YAMLNode loadString( const char *str, size_t len );
+      static YAMLNode loadStringInSitu( char *str ); // zero-copy, modifies str
+      static YAMLNode loadStringInSitu( char *str, size_t len ); // zero-copy, modifies str, str[len] must be writable
       static YAMLNode loadStream( Stream &stream );
       static YAMLNode loadStream( yaml_stream_handler_data_t &stream_handler_data );
+      // path-filtered loading: only the subtrees selected by 'paths' (gettext syntax, max 32) are composed
+      static YAMLNode loadString( const char *str, const char* const* paths, size_t paths_count, char delimiter=':' );
+      static YAMLNode loadStream( Stream &stream, const char* const* paths, size_t paths_count, char delimiter=':' );
+      // binary snapshot, see saveSnapshot()
+      static YAMLNode loadSnapshot( const uint8_t* image, size_t size ); // zero-copy, image must be 4 bytes aligned and outlive the document
+      static YAMLNode loadSnapshot( Stream &stream );
+      static size_t saveSnapshot( yaml_document_t* document, Stream &stream );
 
       // serialization
       static size_t toJSON( yaml_traverser_t *it );
@@ -220,12 +351,14 @@ namespace YAML
 
 
       const char* scalar() const;
-      const char* gettext( const char* path, char delimiter=':' );
+      const char* gettext( const char* path, char delimiter=':' ) const;
+      const char* gettext( const yaml_path_t &path ) const;
 
       YAMLNode& operator = ( const YAMLNode& ) = default;
       YAMLNode& operator = ( YAMLNode&& ) = default;
       YAMLNode operator [] ( int i ) const;
       YAMLNode operator [] ( const char *str ) const;
+      YAMLNode operator [] ( const yaml_path_t &path ) const;
 
       size_t size() const;
 
@@ -242,6 +375,101 @@ namespace YAML
 
     };
 
+
+    // iterates the documents of a multi-document stream, keeping one parser alive
+    class YAMLDocumentReader
+    {
+    public:
+      enum InputFormat_t
+      {
+        INPUT_YAML_STREAM, // '---' separated documents
+        INPUT_JSON_LINES   // one JSON value per line, blank lines are ignored
+      };
+    private:
+      yaml_parser_t parser;
+      InputFormat_t format;
+      size_t bytes_read = 0;
+      yaml_stream_handler_data_t *shd = nullptr;
+      const char* input = nullptr; // JSON-lines string input, not consumed yet
+      size_t input_len = 0;
+      std::string pending;         // JSON-lines stream input, read but not consumed yet
+      size_t pending_pos = 0;
+      size_t docs_count = 0;
+      bool done = false;
+      bool failed = false;
+      void init();
+      bool nextLine( const char** line, size_t* len );
+      bool nextRecord( YAMLNode &node );
+    public:
+      YAMLDocumentReader( Stream &stream, InputFormat_t format=INPUT_YAML_STREAM );
+      YAMLDocumentReader( const char* str, InputFormat_t format=INPUT_YAML_STREAM ); // 'str' must outlive the reader
+      YAMLDocumentReader( const char* str, size_t len, InputFormat_t format=INPUT_YAML_STREAM );
+      YAMLDocumentReader( const YAMLDocumentReader& ) = delete;
+      YAMLDocumentReader& operator = ( const YAMLDocumentReader& ) = delete;
+      ~YAMLDocumentReader();
+
+      bool next( YAMLNode &node ); // releases 'node' then loads the next document, false at end of stream or on error
+      bool error() const { return failed; }
+      size_t count() const { return docs_count; }       // documents read so far
+      size_t bytesRead() const { return bytes_read; }   // stream input only
+
+      // range-for support: for( YAMLNode &doc : reader )
+      class iterator
+      {
+        YAMLDocumentReader *reader;
+        YAMLNode node;
+      public:
+        iterator( YAMLDocumentReader *r ) : reader(r) { if( reader ) ++(*this); }
+        YAMLNode& operator * () { return node; }
+        iterator& operator ++ () { if( reader && !reader->next( node ) ) reader = nullptr; return *this; }
+        bool operator != ( const iterator &other ) const { return reader != other.reader; }
+      };
+      iterator begin() { return iterator( this ); }
+      iterator end() { return iterator( nullptr ); }
+    };
+
+
+    // read-only node view over a binary snapshot (see YAMLNode::saveSnapshot), nothing is allocated
+    class YAMLNodeView
+    {
+      std::shared_ptr<const void> mMapping; // optional, keeps a mapped file/partition alive
+      const uint8_t *mImage = nullptr;      // snapshot image
+      uint32_t mNode = 0;                   // node id, 0=null
+    public:
+      using Type = YAMLNode::Type;
+
+      YAMLNodeView() = default;
+      YAMLNodeView( const uint8_t* image, size_t size ); // image must be 4 bytes aligned and outlive the view
+      YAMLNodeView( std::shared_ptr<const void> mapping, const uint8_t* image, uint32_t node ) :
+        mMapping(mapping),
+        mImage(image),
+        mNode(node)
+      {}
+
+      #if defined YAML_SNAPSHOT_MAP_FILE
+        static YAMLNodeView mapFile( const char* path );
+      #endif
+      #if defined YAML_SNAPSHOT_MAP_PARTITION
+        static YAMLNodeView mapPartition( const char* label );
+      #endif
+
+      Type type() const;
+      const char* scalar() const;
+      const char* gettext( const char* path, char delimiter=':' ) const;
+      const char* gettext( const yaml_path_t &path ) const;
+
+      YAMLNodeView operator [] ( int i ) const;
+      YAMLNodeView operator [] ( const char *str ) const;
+      YAMLNodeView operator [] ( const yaml_path_t &path ) const;
+
+      size_t size() const;
+
+      bool isScalar() const { return type() == Type::Scalar; }
+      bool isSequence() const { return type() == Type::Sequence; }
+      bool isMap() const { return type() == Type::Map; }
+      bool isNull() const { return type() == Type::Null; }
+    };
+
   };
 
 
@@ -251,8 +479,8 @@ namespace YAML
     using namespace logger;
     using namespace helpers;
     using YAMLNode_Class::YAMLNode;
-    // Pure libyaml JSON <-> YAML stream-to-stream seralization
-    // size_t serializeYml( Stream &json_src_stream, Stream &yml_dest_stream, OutputFormat_t format=YAMLParser::OUTPUT_YAML );
+    // Pure libyaml JSON <-> YAML stream-to-stream seralization, returns 0 on failure
+    size_t serializeYml( Stream &src_stream, Stream &dest_stream, OutputFormat_t format=OUTPUT_YAML );
 
     // JSON/YAML document to YAML/JSON string
     size_t serializeYml( yaml_document_t* src_doc, String &dest_string, OutputFormat_t format=OUTPUT_YAML );
@@ -263,6 +491,9 @@ namespace YAML
     int deserializeYml( YAMLNode& dest_obj, const char* src_yaml_str );
     // YAML string to YAML document
     int deserializeYml( YAMLNode& dest_obj, Stream &src_stream );
+    // YAML stream/string to SAX events, returns the read size or -1 on error
+    int deserializeYml( YAMLEventHandler& handler, Stream &src_stream );
+    int deserializeYml( YAMLEventHandler& handler, const char* src_yaml_str );
   };
 
 
@@ -287,11 +518,10 @@ namespace YAML
         return resolvePath(variant[key], tail...);
       }
 
-      // default name for the topmost temporary JsonObject
-      #define ROOT_NODE "_root_"
       // deconstructors
       DeserializationError deserializeYml_JsonObject( yaml_document_t*, yaml_node_t* , JsonVariant, YAMLNode::Type nt=YAMLNode::Type::Null, const char *nodename="", int depth=0 );
       size_t serializeYml_JsonVariant( JsonVariant root, Stream &out, int depth_level, YAMLNode::Type nt );
+      size_t serializeYml_JsonVariant( JsonVariant root, yaml_output_buffer_t *out, const yaml_serializer_context_t* ctx, int depth_level, YAMLNode::Type nt );
 
       class YAMLToArduinoJson
       {
@@ -341,7 +571,9 @@ namespace YAML
 
       // deconstructors
       cJSON* deserializeYml_cJSONObject(yaml_document_t* document, yaml_node_t * yamlNode);
+      cJSON* deserializeYml_cJSONPool(yaml_document_t* document, yaml_node_t * yamlNode);
       size_t serializeYml_cJSONObject( cJSON *root, Stream &out, int depth, YAMLNode::Type nt );
+      size_t serializeYml_cJSONObject( cJSON *root, yaml_output_buffer_t *out, const yaml_serializer_context_t* ctx, int depth, YAMLNode::Type nt );
 
       class YAMLToCJson
       {
@@ -365,6 +597,15 @@ namespace YAML
       // YAML document to cJSON object
       int deserializeYml( cJSON** dest_obj, yaml_document_t* src_document );
 
+      // YAML string to cJSON object allocated as a single block, read-only
+      int deserializeYmlPool( cJSON** dest_obj, const char* src_yaml_str );
+      // YAML stream to cJSON object allocated as a single block, read-only
+      int deserializeYmlPool( cJSON** dest_obj, Stream &src_stream );
+      // YAML document to cJSON object allocated as a single block, read-only
+      int deserializeYmlPool( cJSON** dest_obj, yaml_document_t* src_document );
+      // release a cJSON object from deserializeYmlPool(), cJSON_Delete() must not be used on those
+      void deleteYml_cJSONPool( cJSON* root );
+
     };
   #endif // HAS_CJSON
 
@@ -413,18 +654,40 @@ namespace YAML
 
 
       public:
-        i18n_t() { };
+        i18n_t();
         ~i18n_t();
+        i18n_t( const i18n_t& ) = delete;
+        i18n_t& operator=( const i18n_t& ) = delete;
         i18n_t( const char* localeStr, YAMLNode &Node );
 
         bool setLocale( const char* localeStr, YAMLNode &node );
         const char* gettext( const char* l10npath, char delimiter=':' );
 
+        // gettext() cache, invalidated when the locale changes
+        void setCacheSize( size_t slots ); // 0=disabled
+        void clearCache();
+        void resetCacheStats();
+        size_t cacheHits() const { return cache_hits; }
+        size_t cacheMisses() const { return cache_misses; }
+
       private:
 
         i18n_locale_t locale; // Deconstructed locale
         YAMLNode l10n;        // Localization set, deserialized as YAMLNode
 
+        // Direct-mapped cache of resolved paths, keyed on path pointer + content hash
+        struct cache_entry_t
+        {
+          const char* path;  // l10npath as given to gettext(), nullptr = empty slot
+          uint32_t hash;     // path content hash, detects reused buffers
+          char delimiter;
+          const char* value; // gettext() result
+        };
+        cache_entry_t* cache = nullptr; // allocated on first gettext()
+        size_t cache_size;              // slots, I18N_CACHE_SIZE unless setCacheSize() was called
+        size_t cache_hits = 0;
+        size_t cache_misses = 0;
+
         constexpr static const char delimiters[2] = {'-', '_'}; // Supported locale delimiters
 
         const std::string getLocale(); // reconstruct locale
@@ -451,7 +714,10 @@ namespace YAML
 
 
 using YAML::YAMLNode_Class::YAMLNode;
+using YAML::YAMLNode_Class::YAMLNodeView;
+using YAML::YAMLNode_Class::YAMLDocumentReader;
 using YAML::StringStream;
+using YAML::YAMLEventHandler;
 
 using namespace YAML::libyaml_native;
 
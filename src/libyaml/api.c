@@ -23,6 +23,94 @@ yaml_get_version(int *major, int *minor, int *patch)
     *patch = YAML_VERSION_PATCH;
 }
 
+/*
+ * The allocator in use, NULL means malloc/realloc/free.
+ */
+
+static YAML_THREAD_LOCAL const yaml_allocator_t *yaml_allocator = NULL;
+
+/*
+ * Set the allocator.
+ */
+
+YAML_DECLARE(const yaml_allocator_t *)
+yaml_set_allocator(const yaml_allocator_t *allocator)
+{
+    const yaml_allocator_t *previous = yaml_allocator;
+    yaml_allocator = allocator;
+    return previous;
+}
+
+/*
+ * Statistics counters.
+ */
+
+#if defined(YAML_ENABLE_STATS)
+
+static YAML_THREAD_LOCAL yaml_stats_t yaml_stats;
+
+/* Blocks from the default allocator are prefixed with their size. */
+#define YAML_STATS_HEADER   (2*sizeof(size_t))
+
+YAML_DECLARE(yaml_stats_t *)
+yaml_get_stats(void)
+{
+    return &yaml_stats;
+}
+
+YAML_DECLARE(void)
+yaml_reset_stats(void)
+{
+    size_t bytes_current = yaml_stats.bytes_current;
+    memset(&yaml_stats, 0, sizeof(yaml_stats));
+    yaml_stats.bytes_current = yaml_stats.bytes_peak = bytes_current;
+}
+
+YAML_DECLARE(void)
+yaml_stats_alloc(size_t size)
+{
+    yaml_stats.allocs ++;
+    yaml_stats.bytes_current += size;
+    if (yaml_stats.bytes_current > yaml_stats.bytes_peak)
+        yaml_stats.bytes_peak = yaml_stats.bytes_current;
+}
+
+YAML_DECLARE(void)
+yaml_stats_free(size_t size)
+{
+    /* Blocks may be released by another thread than their owner. */
+    yaml_stats.frees ++;
+    yaml_stats.bytes_current -= (size > yaml_stats.bytes_current)
+        ? yaml_stats.bytes_current : size;
+}
+
+#else
+
+YAML_DECLARE(yaml_stats_t *)
+yaml_get_stats(void)
+{
+    return NULL;
+}
+
+YAML_DECLARE(void)
+yaml_reset_stats(void)
+{
+}
+
+YAML_DECLARE(void)
+yaml_stats_alloc(size_t size)
+{
+    (void)size;
+}
+
+YAML_DECLARE(void)
+yaml_stats_free(size_t size)
+{
+    (void)size;
+}
+
+#endif
+
 /*
  * Allocate a dynamic memory block.
  */
@@ -30,7 +118,20 @@ yaml_get_version(int *major, int *minor, int *patch)
 YAML_DECLARE(void *)
 yaml_malloc(size_t size)
 {
+    if (yaml_allocator)
+        return yaml_allocator->malloc(yaml_allocator->data, size ? size : 1);
+
+#if defined(YAML_ENABLE_STATS)
+    {
+        size_t *block = (size_t *)malloc(YAML_STATS_HEADER + (size ? size : 1));
+        if (!block) return NULL;
+        block[0] = size;
+        yaml_stats_alloc(size);
+        return (char *)block + YAML_STATS_HEADER;
+    }
+#else
     return malloc(size ? size : 1);
+#endif
 }
 
 /*
@@ -40,7 +141,23 @@ yaml_malloc(size_t size)
 YAML_DECLARE(void *)
 yaml_realloc(void *ptr, size_t size)
 {
-    return ptr ? realloc(ptr, size ? size : 1) : malloc(size ? size : 1);
+    if (yaml_allocator)
+        return yaml_allocator->realloc(yaml_allocator->data, ptr, size ? size : 1);
+
+#if defined(YAML_ENABLE_STATS)
+    if (ptr) {
+        size_t *block = (size_t *)((char *)ptr - YAML_STATS_HEADER);
+        size_t previous = block[0];
+        block = (size_t *)realloc(block, YAML_STATS_HEADER + (size ? size : 1));
+        if (!block) return NULL;
+        block[0] = size;
+        yaml_stats_free(previous);
+        yaml_stats_alloc(size);
+        return (char *)block + YAML_STATS_HEADER;
+    }
+#endif
+
+    return ptr ? realloc(ptr, size ? size : 1) : yaml_malloc(size);
 }
 
 /*
@@ -50,7 +167,20 @@ yaml_realloc(void *ptr, size_t size)
 YAML_DECLARE(void)
 yaml_free(void *ptr)
 {
+    if (yaml_allocator) {
+        yaml_allocator->free(yaml_allocator->data, ptr);
+        return;
+    }
+
+#if defined(YAML_ENABLE_STATS)
+    if (ptr) {
+        size_t *block = (size_t *)((char *)ptr - YAML_STATS_HEADER);
+        yaml_stats_free(block[0]);
+        free(block);
+    }
+#else
     if (ptr) free(ptr);
+#endif
 }
 
 /*
@@ -60,10 +190,18 @@ yaml_free(void *ptr)
 YAML_DECLARE(yaml_char_t *)
 yaml_strdup(const yaml_char_t *str)
 {
+    size_t length;
+    yaml_char_t *copy;
+
     if (!str)
         return NULL;
 
-    return (yaml_char_t *)strdup((char *)str);
+    length = strlen((char *)str) + 1;
+    copy = (yaml_char_t *)yaml_malloc(length);
+    if (copy)
+        memcpy(copy, str, length);
+
+    return copy;
 }
 
 /*
@@ -301,6 +439,19 @@ yaml_parser_set_input_string(yaml_parser_t *parser,
     parser->input.string.end = input+size;
 }
 
+/*
+ * Set a mutable string input for in-situ scanning.
+ */
+
+YAML_DECLARE(void)
+yaml_parser_set_input_string_insitu(yaml_parser_t *parser,
+        unsigned char *input, size_t size)
+{
+    yaml_parser_set_input_string(parser, input, size);
+
+    parser->insitu = 1;
+}
+
 /*
  * Set a file input.
  */
@@ -1227,6 +1378,7 @@ yaml_document_add_scalar(yaml_document_t *document,
 
     SCALAR_NODE_INIT(node, tag_copy, value_copy, length, style, mark, mark);
     if (!PUSH(&context, document->nodes, node)) goto error;
+    YAML_STATS_ADD(nodes, 1);
 
     return document->nodes.top - document->nodes.start;
 
@@ -1272,6 +1424,7 @@ yaml_document_add_sequence(yaml_document_t *document,
     SEQUENCE_NODE_INIT(node, tag_copy, items.start, items.end,
             style, mark, mark);
     if (!PUSH(&context, document->nodes, node)) goto error;
+    YAML_STATS_ADD(nodes, 1);
 
     return document->nodes.top - document->nodes.start;
 
@@ -1317,6 +1470,7 @@ yaml_document_add_mapping(yaml_document_t *document,
     MAPPING_NODE_INIT(node, tag_copy, pairs.start, pairs.end,
             style, mark, mark);
     if (!PUSH(&context, document->nodes, node)) goto error;
+    YAML_STATS_ADD(nodes, 1);
 
     return document->nodes.top - document->nodes.start;
 
@@ -75,6 +75,12 @@
 /* Define the version string. */
 #define YAML_VERSION_STRING "0.2.5"
 
+/* Define to enable the statistics counters (see yaml_get_stats()). */
+/* #undef YAML_ENABLE_STATS */
+
+/* Define to scan the input without SSE2/NEON instructions. */
+/* #undef YAML_DISABLE_SIMD */
+
 /* Define to empty if 'const' does not conform to ANSI C. */
 /* #undef const */
 
@@ -392,6 +392,7 @@ yaml_parser_load_scalar(yaml_parser_t *parser, yaml_event_t *event,
             event->start_mark, event->end_mark);
 
     if (!PUSH(parser, parser->document->nodes, node)) goto error;
+    YAML_STATS_ADD(nodes, 1);
 
     index = parser->document->nodes.top - parser->document->nodes.start;
 
@@ -439,6 +440,7 @@ yaml_parser_load_sequence(yaml_parser_t *parser, yaml_event_t *event,
             event->start_mark, event->end_mark);
 
     if (!PUSH(parser, parser->document->nodes, node)) goto error;
+    YAML_STATS_ADD(nodes, 1);
 
     index = parser->document->nodes.top - parser->document->nodes.start;
 
@@ -507,6 +509,7 @@ yaml_parser_load_mapping(yaml_parser_t *parser, yaml_event_t *event,
             event->start_mark, event->end_mark);
 
     if (!PUSH(parser, parser->document->nodes, node)) goto error;
+    YAML_STATS_ADD(nodes, 1);
 
     index = parser->document->nodes.top - parser->document->nodes.start;
 
@@ -56,6 +56,7 @@
 #define SKIP_TOKEN(parser)                                                      \
     (parser->token_available = 0,                                               \
      parser->tokens_parsed ++,                                                  \
+     YAML_STATS_ADD(tokens, 1),                                                 \
      parser->stream_end_produced =                                              \
         (parser->tokens.head->type == YAML_STREAM_END_TOKEN),                   \
      parser->tokens.head ++)
@@ -197,7 +198,12 @@ yaml_parser_parse(yaml_parser_t *parser, yaml_event_t *event)
 
     /* Generate the next event. */
 
-    return yaml_parser_state_machine(parser, event);
+    if (!yaml_parser_state_machine(parser, event))
+        return 0;
+
+    YAML_STATS_ADD(events, 1);
+
+    return 1;
 }
 
 /*
@@ -15,6 +15,9 @@ yaml_parser_update_raw_buffer(yaml_parser_t *parser);
 static int
 yaml_parser_determine_encoding(yaml_parser_t *parser);
 
+static size_t
+yaml_parser_ascii_run(yaml_parser_t *parser);
+
 YAML_DECLARE(int)
 yaml_parser_update_buffer(yaml_parser_t *parser, size_t length);
 
@@ -124,6 +127,7 @@ yaml_parser_update_raw_buffer(yaml_parser_t *parser)
                 parser->offset, -1);
     }
     parser->raw_buffer.last += size_read;
+    YAML_STATS_ADD(bytes_in, size_read);
     if (!size_read) {
         parser->eof = 1;
     }
@@ -131,6 +135,106 @@ yaml_parser_update_raw_buffer(yaml_parser_t *parser)
     return 1;
 }
 
+#define IS_PRINTABLE_ASCII(octet)                                               \
+    ((octet) == 0x09 || (octet) == 0x0A || (octet) == 0x0D                      \
+     || ((octet) >= 0x20 && (octet) <= 0x7E))
+
+/*
+ * Count the printable ASCII characters (#x9 | #xA | #xD | [#x20-#x7E]) at the
+ * raw buffer pointer, 16 bytes at a time with SSE2/NEON or one word at a time
+ * otherwise. UTF-8 input is copied verbatim for that many bytes.
+ *
+ * The vector loads may read past the raw bytes, but never past the end of the
+ * raw buffer allocation; the extra lanes are masked out.
+ */
+
+static size_t
+yaml_parser_ascii_run(yaml_parser_t *parser)
+{
+    const unsigned char *pointer = parser->raw_buffer.pointer;
+    size_t limit = parser->raw_buffer.last - parser->raw_buffer.pointer;
+    size_t length = 0;
+
+#if defined(YAML_SIMD_SSE2)
+
+    while (length < limit && pointer + length + 16 <= parser->raw_buffer.end)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(pointer + length));
+        unsigned int stops;
+
+        /* Signed compares: the bytes above 0x7F are negative. */
+        stops = ~_mm_movemask_epi8(_mm_or_si128(
+                    _mm_and_si128(
+                        _mm_cmpgt_epi8(chunk, _mm_set1_epi8(0x1F)),
+                        _mm_cmplt_epi8(chunk, _mm_set1_epi8(0x7F))),
+                    _mm_or_si128(
+                        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t')),
+                        _mm_or_si128(
+                            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')),
+                            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))))));
+        if (limit - length < 16)
+            stops |= ~0U << (limit - length);
+        stops &= 0xFFFF;
+        if (stops)
+            return length + __builtin_ctz(stops);
+        length += 16;
+    }
+
+#elif defined(YAML_SIMD_NEON)
+
+    while (length < limit && pointer + length + 16 <= parser->raw_buffer.end)
+    {
+        uint8x16_t chunk = vld1q_u8(pointer + length);
+        uint8x16_t allowed;
+        uint64_t mask;
+
+        allowed = vorrq_u8(
+                vandq_u8(vcgeq_u8(chunk, vdupq_n_u8(0x20)),
+                    vcleq_u8(chunk, vdupq_n_u8(0x7E))),
+                vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\t')),
+                    vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\n')),
+                        vceqq_u8(chunk, vdupq_n_u8('\r')))));
+
+        /* Narrow the comparison to 4 bits per byte. */
+        mask = ~vget_lane_u64(vreinterpret_u64_u8(
+                    vshrn_n_u16(vreinterpretq_u16_u8(allowed), 4)), 0);
+        if (limit - length < 16)
+            mask |= ~(uint64_t)0 << ((limit - length) * 4);
+        if (mask)
+            return length + (__builtin_ctzll(mask) >> 2);
+        length += 16;
+    }
+
+#else
+
+    /* Words holding a byte below 0x20 or above 0x7E are checked bytewise. */
+
+    const size_t ones = (size_t)-1/0xFF;
+    const size_t highs = ones*0x80;
+
+    while (length + sizeof(size_t) <= limit)
+    {
+        size_t word;
+        size_t index;
+
+        memcpy(&word, pointer + length, sizeof(size_t));
+        if ((((word - ones*0x20) & ~word) | word | (word + ones)) & highs) {
+            for (index = 0; index < sizeof(size_t); index ++) {
+                if (!IS_PRINTABLE_ASCII(pointer[length+index]))
+                    return length + index;
+            }
+        }
+        length += sizeof(size_t);
+    }
+
+#endif
+
+    while (length < limit && IS_PRINTABLE_ASCII(pointer[length]))
+        length ++;
+
+    return length;
+}
+
 /*
  * Ensure that the buffer contains at least `length` characters.
  * Return 1 on success, 0 on failure.
@@ -199,6 +303,22 @@ yaml_parser_update_buffer(yaml_parser_t *parser, size_t length)
             size_t k;
             size_t raw_unread = parser->raw_buffer.last - parser->raw_buffer.pointer;
 
+            /*
+             * UTF-8 fast path: printable ASCII needs no decoding, copy the
+             * whole run. The offset still counts raw bytes, so the buffer
+             * stays a verbatim copy of the input (see in-situ mode).
+             */
+
+            if (parser->encoding == YAML_UTF8_ENCODING
+                    && (k = yaml_parser_ascii_run(parser)) != 0) {
+                memcpy(parser->buffer.last, parser->raw_buffer.pointer, k);
+                parser->buffer.last += k;
+                parser->raw_buffer.pointer += k;
+                parser->offset += k;
+                parser->unread += k;
+                continue;
+            }
+
             /* Decode the next character. */
 
             switch (parser->encoding)
@@ -567,6 +567,242 @@
       parser->unread --) : 0),                                                  \
     1) : 0)
 
+/*
+ * Advance the buffer pointer over a run of ASCII characters on the same line.
+ */
+
+#define SKIP_RUN(parser,length)                                                 \
+     (parser->mark.index += (length),                                           \
+      parser->mark.column += (length),                                          \
+      parser->unread -= (length),                                               \
+      parser->buffer.pointer += (length))
+
+/*
+ * Character classes for yaml_parser_scan_run().
+ */
+
+typedef enum yaml_run_class_e {
+    /* Spaces. */
+    YAML_RUN_SPACES,
+    /* Spaces and tabs. */
+    YAML_RUN_BLANKS,
+    /* Anything but a line break or NUL (comment text). */
+    YAML_RUN_COMMENT,
+    /* Plain scalar characters that are neither blank nor ':'. */
+    YAML_RUN_PLAIN,
+    /* Same as YAML_RUN_PLAIN, flow indicators excluded. */
+    YAML_RUN_PLAIN_FLOW
+} yaml_run_class_t;
+
+/*
+ * Check if a byte ends a run of the given class. Bytes above 0x7F always
+ * do: the caller falls back to the per-character macros for them.
+ */
+
+static inline int
+yaml_parser_run_stops(yaml_char_t c, yaml_run_class_t run_class)
+{
+    switch (run_class) {
+        case YAML_RUN_SPACES:
+            return c != ' ';
+        case YAML_RUN_BLANKS:
+            return c != ' ' && c != '\t';
+        case YAML_RUN_COMMENT:
+            return c == '\r' || c == '\n' || c == '\0' || c >= 0x80;
+        case YAML_RUN_PLAIN_FLOW:
+            if (c == ',' || c == '[' || c == ']' || c == '{' || c == '}')
+                return 1;
+            /* Fall through. */
+        default:
+            return c <= ' ' || c >= 0x80 || c == ':';
+    }
+}
+
+#if !defined(YAML_SIMD_SSE2) && !defined(YAML_SIMD_NEON)
+
+/*
+ * Word at a time version of yaml_parser_run_stops(). May report false
+ * positives, never false negatives.
+ */
+
+#define RUN_ONES                ((size_t)-1/0xFF)
+#define RUN_HIGHS               (RUN_ONES*0x80)
+#define RUN_HAS_ZERO(word)      (((word) - RUN_ONES) & ~(word) & RUN_HIGHS)
+#define RUN_HAS_BYTE(word,c)    RUN_HAS_ZERO((word) ^ (RUN_ONES*(c)))
+
+static inline int
+yaml_parser_run_word_stops(size_t word, yaml_run_class_t run_class)
+{
+    switch (run_class) {
+        case YAML_RUN_SPACES:
+        case YAML_RUN_BLANKS:
+            return word != RUN_ONES*' ';
+        case YAML_RUN_COMMENT:
+            return ((word & RUN_HIGHS) | RUN_HAS_ZERO(word)
+                    | RUN_HAS_BYTE(word, '\r') | RUN_HAS_BYTE(word, '\n')) != 0;
+        case YAML_RUN_PLAIN_FLOW:
+            if (RUN_HAS_BYTE(word, ',') | RUN_HAS_BYTE(word, '[')
+                    | RUN_HAS_BYTE(word, ']') | RUN_HAS_BYTE(word, '{')
+                    | RUN_HAS_BYTE(word, '}'))
+                return 1;
+            /* Fall through. */
+        default:
+            /* Bytes up to ' ', above 0x7F, or ':'. */
+            return (((word - RUN_ONES*0x21) & ~word & RUN_HIGHS)
+                    | (word & RUN_HIGHS) | RUN_HAS_BYTE(word, ':')) != 0;
+    }
+}
+
+#endif
+
+/*
+ * Count the characters at the buffer pointer that belong to the given class,
+ * 16 bytes at a time with SSE2/NEON or one word at a time otherwise. Only
+ * decoded characters are examined: the run is ASCII, so its length is both
+ * a byte and a character count and never exceeds parser->unread.
+ *
+ * The vector loads may read past the decoded characters, but never past the
+ * end of the buffer allocation; the extra lanes are masked out.
+ */
+
+static inline size_t
+yaml_parser_scan_run(yaml_parser_t *parser, yaml_run_class_t run_class)
+{
+    const yaml_char_t *pointer = parser->buffer.pointer;
+    size_t limit = parser->unread;
+    size_t length = 0;
+
+#if defined(YAML_SIMD_SSE2)
+
+    const __m128i space = _mm_set1_epi8(' ');
+
+    while (length < limit && pointer + length + 16 <= parser->buffer.end)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(pointer + length));
+        __m128i indicators;
+        unsigned int stops;
+
+        switch (run_class) {
+            case YAML_RUN_SPACES:
+                stops = ~_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, space));
+                break;
+            case YAML_RUN_BLANKS:
+                stops = ~_mm_movemask_epi8(_mm_or_si128(
+                            _mm_cmpeq_epi8(chunk, space),
+                            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))));
+                break;
+            case YAML_RUN_COMMENT:
+                /* The sign bits flag the bytes above 0x7F. */
+                stops = _mm_movemask_epi8(chunk)
+                    | _mm_movemask_epi8(_mm_or_si128(
+                            _mm_cmpeq_epi8(chunk, _mm_setzero_si128()),
+                            _mm_or_si128(
+                                _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r')),
+                                _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')))));
+                break;
+            default:
+                indicators = _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':'));
+                if (run_class == YAML_RUN_PLAIN_FLOW) {
+                    indicators = _mm_or_si128(indicators, _mm_or_si128(
+                                _mm_or_si128(
+                                    _mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')),
+                                    _mm_cmpeq_epi8(chunk, _mm_set1_epi8('['))),
+                                _mm_or_si128(
+                                    _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']')),
+                                    _mm_or_si128(
+                                        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')),
+                                        _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}'))))));
+                }
+                /* Signed compare: the bytes above 0x7F are negative. */
+                stops = ~_mm_movemask_epi8(_mm_cmpgt_epi8(chunk, space))
+                    | _mm_movemask_epi8(indicators);
+                break;
+        }
+
+        if (limit - length < 16)
+            stops |= ~0U << (limit - length);
+        stops &= 0xFFFF;
+        if (stops)
+            return length + __builtin_ctz(stops);
+        length += 16;
+    }
+
+#elif defined(YAML_SIMD_NEON)
+
+    const uint8x16_t space = vdupq_n_u8(' ');
+
+    while (length < limit && pointer + length + 16 <= parser->buffer.end)
+    {
+        uint8x16_t chunk = vld1q_u8(pointer + length);
+        uint8x16_t stops;
+        uint64_t mask;
+
+        switch (run_class) {
+            case YAML_RUN_SPACES:
+                stops = vmvnq_u8(vceqq_u8(chunk, space));
+                break;
+            case YAML_RUN_BLANKS:
+                stops = vmvnq_u8(vorrq_u8(vceqq_u8(chunk, space),
+                            vceqq_u8(chunk, vdupq_n_u8('\t'))));
+                break;
+            case YAML_RUN_COMMENT:
+                stops = vorrq_u8(
+                        vorrq_u8(vcgeq_u8(chunk, vdupq_n_u8(0x80)),
+                            vceqq_u8(chunk, vdupq_n_u8(0))),
+                        vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('\r')),
+                            vceqq_u8(chunk, vdupq_n_u8('\n'))));
+                break;
+            default:
+                stops = vorrq_u8(
+                        vorrq_u8(vcleq_u8(chunk, space),
+                            vcgeq_u8(chunk, vdupq_n_u8(0x80))),
+                        vceqq_u8(chunk, vdupq_n_u8(':')));
+                if (run_class == YAML_RUN_PLAIN_FLOW) {
+                    stops = vorrq_u8(stops, vorrq_u8(
+                                vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(',')),
+                                    vceqq_u8(chunk, vdupq_n_u8('['))),
+                                vorrq_u8(vceqq_u8(chunk, vdupq_n_u8(']')),
+                                    vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('{')),
+                                        vceqq_u8(chunk, vdupq_n_u8('}'))))));
+                }
+                break;
+        }
+
+        /* Narrow the comparison to 4 bits per byte. */
+        mask = vget_lane_u64(vreinterpret_u64_u8(
+                    vshrn_n_u16(vreinterpretq_u16_u8(stops), 4)), 0);
+        if (limit - length < 16)
+            mask |= ~(uint64_t)0 << ((limit - length) * 4);
+        if (mask)
+            return length + (__builtin_ctzll(mask) >> 2);
+        length += 16;
+    }
+
+#else
+
+    while (length + sizeof(size_t) <= limit)
+    {
+        size_t word;
+        size_t index;
+
+        memcpy(&word, pointer + length, sizeof(size_t));
+        if (yaml_parser_run_word_stops(word, run_class)) {
+            for (index = 0; index < sizeof(size_t); index ++) {
+                if (yaml_parser_run_stops(pointer[length+index], run_class))
+                    return length + index;
+            }
+        }
+        length += sizeof(size_t);
+    }
+
+#endif
+
+    while (length < limit && !yaml_parser_run_stops(pointer[length], run_class))
+        length ++;
+
+    return length;
+}
+
 /*
  * Public API declarations.
  */
@@ -735,6 +971,31 @@ yaml_parser_scan_flow_scalar(yaml_parser_t *parser, yaml_token_t *token,
 static int
 yaml_parser_scan_plain_scalar(yaml_parser_t *parser, yaml_token_t *token);
 
+static yaml_char_t *
+yaml_parser_insitu_pointer(yaml_parser_t *parser);
+
+/*
+ * Get the position of the buffer pointer in the in-situ input, or NULL.
+ *
+ * UTF-8 input is decoded verbatim, so the unread part of the buffer maps
+ * to the bytes preceding the raw offset (minus the NUL appended on EOF).
+ */
+
+static yaml_char_t *
+yaml_parser_insitu_pointer(yaml_parser_t *parser)
+{
+    size_t unread;
+
+    if (!parser->insitu || parser->encoding != YAML_UTF8_ENCODING)
+        return NULL;
+
+    unread = parser->buffer.last - parser->buffer.pointer;
+    if (parser->eof && unread)
+        unread --;
+
+    return (yaml_char_t *)parser->input.string.start + parser->offset - unread;
+}
+
 /*
  * Get the next token.
  */
@@ -767,6 +1028,7 @@ yaml_parser_scan(yaml_parser_t *parser, yaml_token_t *token)
     *token = DEQUEUE(parser, parser->tokens);
     parser->token_available = 0;
     parser->tokens_parsed ++;
+    YAML_STATS_ADD(tokens, 1);
 
     if (token->type == YAML_STREAM_END_TOKEN) {
         parser->stream_end_produced = 1;
@@ -1919,6 +2181,8 @@ yaml_parser_fetch_plain_scalar(yaml_parser_t *parser)
 static int
 yaml_parser_scan_to_next_token(yaml_parser_t *parser)
 {
+    size_t length;
+
     /* Until the next token is not found. */
 
     while (1)
@@ -1945,7 +2209,11 @@ yaml_parser_scan_to_next_token(yaml_parser_t *parser)
         while (CHECK(parser->buffer,' ') ||
                 ((parser->flow_level || !parser->simple_key_allowed) &&
                  CHECK(parser->buffer, '\t'))) {
-            SKIP(parser);
+            if (parser->flow_level || !parser->simple_key_allowed)
+                length = yaml_parser_scan_run(parser, YAML_RUN_BLANKS);
+            else
+                length = yaml_parser_scan_run(parser, YAML_RUN_SPACES);
+            SKIP_RUN(parser, length);
             if (!CACHE(parser, 1)) return 0;
         }
 
@@ -1953,7 +2221,11 @@ yaml_parser_scan_to_next_token(yaml_parser_t *parser)
 
         if (CHECK(parser->buffer, '#')) {
             while (!IS_BREAKZ(parser->buffer)) {
-                SKIP(parser);
+                length = yaml_parser_scan_run(parser, YAML_RUN_COMMENT);
+                if (length)
+                    SKIP_RUN(parser, length);
+                else
+                    SKIP(parser);
                 if (!CACHE(parser, 1)) return 0;
             }
         }
@@ -3032,6 +3304,7 @@ yaml_parser_scan_flow_scalar(yaml_parser_t *parser, yaml_token_t *token,
     yaml_string_t trailing_breaks = NULL_STRING;
     yaml_string_t whitespaces = NULL_STRING;
     int leading_blanks;
+    yaml_char_t *insitu_start = NULL;
 
     if (!STRING_INIT(parser, string, INITIAL_STRING_SIZE)) goto error;
     if (!STRING_INIT(parser, leading_break, INITIAL_STRING_SIZE)) goto error;
@@ -3044,6 +3317,9 @@ yaml_parser_scan_flow_scalar(yaml_parser_t *parser, yaml_token_t *token,
 
     SKIP(parser);
 
+    if (single)
+        insitu_start = yaml_parser_insitu_pointer(parser);
+
     /* Consume the content of the quoted scalar. */
 
     while (1)
@@ -3363,6 +3639,21 @@ yaml_parser_scan_flow_scalar(yaml_parser_t *parser, yaml_token_t *token,
         }
     }
 
+    /*
+     * In-situ mode: point to the input when no unescaping or folding
+     * occured, and terminate the value by overwriting the right quote.
+     */
+
+    if (insitu_start
+            && yaml_parser_insitu_pointer(parser) - insitu_start == string.pointer - string.start
+            && memcmp(insitu_start, string.start, string.pointer - string.start) == 0)
+    {
+        STRING_DEL(parser, string);
+        string.start = insitu_start;
+        string.pointer = yaml_parser_insitu_pointer(parser);
+        *string.pointer = '\0';
+    }
+
     /* Eat the right quote. */
 
     SKIP(parser);
@@ -3405,8 +3696,15 @@ yaml_parser_scan_plain_scalar(yaml_parser_t *parser, yaml_token_t *token)
     yaml_string_t whitespaces = NULL_STRING;
     int leading_blanks = 0;
     int indent = parser->indent+1;
+    size_t length;
+    yaml_char_t *insitu_start = yaml_parser_insitu_pointer(parser);
+    yaml_char_t *insitu_end = insitu_start;
 
-    if (!STRING_INIT(parser, string, INITIAL_STRING_SIZE)) goto error;
+    /* In-situ mode: the value is not copied until it needs folding. */
+
+    if (!insitu_start) {
+        if (!STRING_INIT(parser, string, INITIAL_STRING_SIZE)) goto error;
+    }
     if (!STRING_INIT(parser, leading_break, INITIAL_STRING_SIZE)) goto error;
     if (!STRING_INIT(parser, trailing_breaks, INITIAL_STRING_SIZE)) goto error;
     if (!STRING_INIT(parser, whitespaces, INITIAL_STRING_SIZE)) goto error;
@@ -3474,6 +3772,18 @@ yaml_parser_scan_plain_scalar(yaml_parser_t *parser, yaml_token_t *token)
 
             if (leading_blanks || whitespaces.start != whitespaces.pointer)
             {
+                if (leading_blanks && insitu_start)
+                {
+                    /* Line folding: copy the in-situ part of the value. */
+
+                    if (!STRING_INIT(parser, string,
+                                INITIAL_STRING_SIZE + (insitu_end - insitu_start)))
+                        goto error;
+                    memcpy(string.start, insitu_start, insitu_end - insitu_start);
+                    string.pointer += insitu_end - insitu_start;
+                    insitu_start = NULL;
+                }
+
                 if (leading_blanks)
                 {
                     /* Do we need to fold line breaks? */
@@ -3500,14 +3810,42 @@ yaml_parser_scan_plain_scalar(yaml_parser_t *parser, yaml_token_t *token)
                 }
                 else
                 {
-                    if (!JOIN(parser, string, whitespaces)) goto error;
+                    if (!insitu_start) {
+                        if (!JOIN(parser, string, whitespaces)) goto error;
+                    }
                     CLEAR(parser, whitespaces);
                 }
             }
 
             /* Copy the character. */
 
-            if (!READ(parser, string)) goto error;
+            if (insitu_start) {
+                SKIP(parser);
+            }
+            else {
+                if (!READ(parser, string)) goto error;
+            }
+
+            /* Copy the following characters that cannot end the scalar. */
+
+            length = yaml_parser_scan_run(parser,
+                    parser->flow_level ? YAML_RUN_PLAIN_FLOW : YAML_RUN_PLAIN);
+            if (length && !insitu_start) {
+                while ((size_t)(string.end - string.pointer) <= length + 5) {
+                    if (!yaml_string_extend(&string.start,
+                                &string.pointer, &string.end)) {
+                        parser->error = YAML_MEMORY_ERROR;
+                        goto error;
+                    }
+                }
+                memcpy(string.pointer, parser->buffer.pointer, length);
+                string.pointer += length;
+            }
+            SKIP_RUN(parser, length);
+
+            if (insitu_start) {
+                insitu_end = yaml_parser_insitu_pointer(parser);
+            }
 
             end_mark = parser->mark;
 
@@ -3541,6 +3879,10 @@ yaml_parser_scan_plain_scalar(yaml_parser_t *parser, yaml_token_t *token)
                 if (!leading_blanks) {
                     if (!READ(parser, whitespaces)) goto error;
                 }
+                else if (IS_SPACE(parser->buffer)) {
+                    length = yaml_parser_scan_run(parser, YAML_RUN_SPACES);
+                    SKIP_RUN(parser, length);
+                }
                 else {
                     SKIP(parser);
                 }
@@ -3571,6 +3913,14 @@ yaml_parser_scan_plain_scalar(yaml_parser_t *parser, yaml_token_t *token)
             break;
     }
 
+    /* In-situ mode: terminate the value in the input. */
+
+    if (insitu_start) {
+        string.start = insitu_start;
+        string.pointer = insitu_end;
+        *string.pointer = '\0';
+    }
+
     /* Create a token. */
 
     SCALAR_TOKEN_INIT(*token, string.start, string.pointer-string.start,
@@ -71,6 +71,119 @@ yaml_get_version(int *major, int *minor, int *patch);
 
 /** @} */
 
+/**
+ * @defgroup allocator Memory Allocator
+ * @{
+ */
+
+/**
+ * The prototype of a custom allocator.
+ *
+ * Every dynamic memory block used by the parser, the emitter and the
+ * documents is obtained through these callbacks when an allocator is set.
+ * The @a free callback may receive a @c NULL pointer, and @a realloc may
+ * receive a @c NULL @a ptr.
+ */
+
+typedef struct yaml_allocator_s {
+    /** Allocate @a size bytes. */
+    void *(*malloc)(void *data, size_t size);
+    /** Resize the block pointed to by @a ptr to @a size bytes. */
+    void *(*realloc)(void *data, void *ptr, size_t size);
+    /** Release the block pointed to by @a ptr. */
+    void (*free)(void *data, void *ptr);
+    /** An application data pointer passed to the callbacks. */
+    void *data;
+} yaml_allocator_t;
+
+/**
+ * Set the allocator used by the current thread.
+ *
+ * Blocks must be released with the allocator that was active when they
+ * were obtained, so the allocator should stay set from the parser (or
+ * emitter) initialization until its deletion.
+ *
+ * Without thread local storage (AVR, compilers other than GCC/Clang
+ * lacking C11 @c _Thread_local) the allocator is shared by all threads,
+ * and only one thread at a time may use a custom allocator.
+ *
+ * @param[in]       allocator   An allocator object or @c NULL to restore
+ *                              the default malloc/realloc/free functions.
+ *
+ * @returns The previously set allocator, or @c NULL.
+ */
+
+YAML_DECLARE(const yaml_allocator_t *)
+yaml_set_allocator(const yaml_allocator_t *allocator);
+
+/**
+ * The statistics counters.
+ *
+ * Only maintained when the library is built with @c YAML_ENABLE_STATS.
+ * Counters are kept per thread where thread local storage is supported.
+ * Heap counters cover blocks obtained with the default allocator, blocks
+ * obtained through a custom allocator are up to the allocator to report.
+ */
+
+typedef struct yaml_stats_s {
+    /** Heap blocks allocated (a reallocation counts as a release and an allocation). */
+    size_t allocs;
+    /** Heap blocks released. */
+    size_t frees;
+    /** Heap bytes currently in use. */
+    size_t bytes_current;
+    /** Highest value reached by @a bytes_current. */
+    size_t bytes_peak;
+    /** Tokens produced by the scanner. */
+    size_t tokens;
+    /** Events produced by the parser. */
+    size_t events;
+    /** Nodes added to documents. */
+    size_t nodes;
+    /** Bytes read from the parser input. */
+    size_t bytes_in;
+    /** Bytes written by the serializers. */
+    size_t bytes_out;
+} yaml_stats_t;
+
+/**
+ * Get the statistics counters of the current thread.
+ *
+ * @returns The counters, or @c NULL if the library was built without
+ * @c YAML_ENABLE_STATS.
+ */
+
+YAML_DECLARE(yaml_stats_t *)
+yaml_get_stats(void);
+
+/**
+ * Reset the statistics counters of the current thread.
+ *
+ * @a bytes_current is kept as it reflects blocks still in use, and
+ * @a bytes_peak restarts from it.
+ */
+
+YAML_DECLARE(void)
+yaml_reset_stats(void);
+
+/**
+ * Account a heap allocation of @a size bytes made on behalf of the library,
+ * e.g. by a custom allocator.
+ */
+
+YAML_DECLARE(void)
+yaml_stats_alloc(size_t size);
+
+/**
+ * Account the release of a heap block of @a size bytes, see
+ * yaml_stats_alloc().
+ */
+
+YAML_DECLARE(void)
+yaml_stats_free(size_t size);
+
+/** @} */
+
 /**
  * @defgroup basic Basic Types
  * @{
@@ -735,6 +848,8 @@ struct yaml_node_s {
             size_t length;
             /** The scalar style. */
             yaml_scalar_style_t style;
+            /** Application defined content class cache, zero when not set. */
+            unsigned char content_class;
         } scalar;
 
         /** The sequence parameters (for @c YAML_SEQUENCE_NODE). */
@@ -1137,6 +1252,9 @@ typedef struct yaml_parser_s {
         FILE *file;
     } input;
 
+    /** Scalars may point into the string input (see yaml_parser_set_input_string_insitu). */
+    int insitu;
+
     /** EOF flag */
     int eof;
 
@@ -1347,6 +1465,29 @@ YAML_DECLARE(void)
 yaml_parser_set_input_string(yaml_parser_t *parser,
         const unsigned char *input, size_t size);
 
+/**
+ * Set a mutable string input for in-situ scanning.
+ *
+ * Plain scalars and single-quoted scalars needing no unescaping nor line
+ * folding are not copied: their value points into @a input, where the
+ * byte following the scalar is overwritten with a NUL character.
+ * Other scalars are allocated as usual.
+ *
+ * The input must be writable and @a input[size] must be a valid NUL byte.
+ * In-situ scanning only applies to UTF-8 input, other encodings are
+ * scanned as usual.  The application must tell in-situ values apart when
+ * releasing memory, e.g. with an allocator ignoring pointers inside
+ * @a input (see yaml_set_allocator).
+ *
+ * @param[in,out]   parser  A parser object.
+ * @param[in,out]   input   A source data, modified by the scanner.
+ * @param[in]       size    The length of the source data in bytes.
+ */
+
+YAML_DECLARE(void)
+yaml_parser_set_input_string_insitu(yaml_parser_t *parser,
+        unsigned char *input, size_t size);
+
 /**
  * Set a file input.
  *
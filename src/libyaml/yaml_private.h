@@ -8,6 +8,47 @@
 #include <limits.h>
 #include <stddef.h>
 
+/*
+ * Thread local storage for the allocator hook and the statistics counters,
+ * where supported (GCC emulates it on targets without native TLS, AVR has
+ * none). Elsewhere they are shared by all threads, see yaml_set_allocator().
+ */
+
+#if !defined(YAML_THREAD_LOCAL)
+#   if defined(__GNUC__) && !defined(__AVR__)
+#       define YAML_THREAD_LOCAL __thread
+#   elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+#       define YAML_THREAD_LOCAL _Thread_local
+#   else
+#       define YAML_THREAD_LOCAL
+#   endif
+#endif
+
+/*
+ * Vector instructions for the scanner fast paths, unless YAML_DISABLE_SIMD
+ * is defined. Other targets scan one machine word at a time.
+ */
+
+#if !defined(YAML_DISABLE_SIMD)
+#   if defined(__SSE2__)
+#       define YAML_SIMD_SSE2
+#       include <emmintrin.h>
+#   elif defined(__ARM_NEON)
+#       define YAML_SIMD_NEON
+#       include <arm_neon.h>
+#   endif
+#endif
+
+/*
+ * Statistics counters, see yaml_get_stats().
+ */
+
+#if defined(YAML_ENABLE_STATS)
+#   define YAML_STATS_ADD(field, n) (yaml_get_stats()->field += (n))
+#else
+#   define YAML_STATS_ADD(field, n) ((void)0)
+#endif
+
 /*
  * Memory management.
  */